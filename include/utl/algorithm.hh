@@ -8,6 +8,14 @@
 #ifndef UTL_ALGORITHM_HH_
 #define UTL_ALGORITHM_HH_
 
+#include <bit>
+#include <utility>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/span.hh>
+#include <utl/ranges.hh>
+
 namespace utl {
 
 template <typename T>
@@ -15,8 +23,524 @@ constexpr T const& max(T const& a, T const& b) {
     return a > b ? a : b;
 }
 
+template <typename T>
+constexpr T const& min(T const& a, T const& b) {
+    return b < a ? b : a;
+}
+
+//The algorithms below never allocate or throw, and are all constexpr.
+//Each takes a pair of random access iterators (pointers, usually), or
+//a range: a utl::array, a utl::span, a C array, or anything else
+//ranges::begin and ranges::end work on.
+//
+//Comparisons are "less than" functions, as in the standard library.
+
+struct less {
+    template <typename T, typename U>
+    constexpr bool operator()(T const& a, U const& b) const { return a < b; }
+};
+
+struct plus {
+    template <typename T, typename U>
+    constexpr auto operator()(T const& a, U const& b) const { return a + b; }
+};
+
+template <typename I>
+concept random_access_iterator = requires(I iter, I other, size_t count) {
+    *iter;
+    ++iter;
+    --iter;
+    iter + count;
+    iter - other;
+    iter < other;
+};
+
+template <typename R>
+using range_value_t = std::remove_cvref_t<decltype(*ranges::begin(std::declval<R&>()))>;
+
+namespace detail::algorithm {
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    //Ranges shorter than this are finished with an insertion sort.
+    inline constexpr size_t small_sort = 16;
+
+    template <typename I>
+    constexpr size_t distance(I first, I last)
+    {
+        return static_cast<size_t>(last - first);
+    }
+
+    template <typename I>
+    constexpr void iter_swap(I a, I b)
+    {
+        auto value = std::move(*a);
+        *a = std::move(*b);
+        *b = std::move(value);
+    }
+
+    template <typename I>
+    constexpr void reverse(I first, I last)
+    {
+        while(first < last) iter_swap(first++, --last);
+    }
+
+    //Swaps [first, middle) and [middle, last); returns where first
+    //ended up.
+    template <typename I>
+    constexpr I rotate(I first, I middle, I last)
+    {
+        reverse(first, middle);
+        reverse(middle, last);
+        reverse(first, last);
+        return first + distance(middle, last);
+    }
+
+    template <typename I, typename C>
+    constexpr void insertion_sort(I first, I last, C& comp)
+    {
+        if(first == last) return;
+        for(auto current = first + 1; current < last; ++current) {
+            auto value = std::move(*current);
+            auto hole = current;
+            for(; hole != first and comp(value, *(hole - 1)); --hole) *hole = std::move(*(hole - 1));
+            *hole = std::move(value);
+        }
+    }
+
+    template <typename I, typename C>
+    constexpr void sift_down(I first, size_t root, size_t size, C& comp)
+    {
+        auto value = std::move(*(first + root));
+        while(2 * root + 1 < size) {
+            size_t child = 2 * root + 1;
+            if(child + 1 < size and comp(*(first + child), *(first + child + 1))) child++;
+            if(not comp(value, *(first + child))) break;
+            *(first + root) = std::move(*(first + child));
+            root = child;
+        }
+        *(first + root) = std::move(value);
+    }
+
+    template <typename I, typename C>
+    constexpr void heap_sort(I first, I last, C& comp)
+    {
+        const size_t size = distance(first, last);
+        for(size_t root = size / 2; root > 0; root--) sift_down(first, root - 1, size, comp);
+        for(size_t end = size; end > 1; end--) {
+            iter_swap(first, first + (end - 1));
+            sift_down(first, 0, end - 1, comp);
+        }
+    }
 
+    //Partitions [first, last), which must hold more than three
+    //elements, around the median of three of them. Returns the start
+    //of the upper part, which is never first or last.
+    template <typename I, typename C>
+    constexpr I partition_pivot(I first, I last, C& comp)
+    {
+        auto a = first + 1;
+        auto b = first + distance(first, last) / 2;
+        auto c = last - 1;
+        //the median goes to *first, to be the pivot
+        if(comp(*a, *b)) {
+            if(comp(*b, *c)) iter_swap(first, b);
+            else if(comp(*a, *c)) iter_swap(first, c);
+            else iter_swap(first, a);
+        } else if(comp(*a, *c)) {
+            iter_swap(first, a);
+        } else if(comp(*b, *c)) {
+            iter_swap(first, c);
+        } else {
+            iter_swap(first, b);
+        }
 
+        //the pivot stops both scans, so neither needs a bounds check
+        auto low = first + 1;
+        auto high = last;
+        while(true) {
+            while(comp(*low, *first)) ++low;
+            --high;
+            while(comp(*first, *high)) --high;
+            if(not (low < high)) return low;
+            iter_swap(low, high);
+            ++low;
+        }
+    }
+
+    template <typename I, typename C>
+    constexpr void introsort(I first, I last, size_t depth, C& comp)
+    {
+        while(distance(first, last) > small_sort) {
+            if(depth == 0) {
+                heap_sort(first, last, comp);
+                return;
+            }
+            depth--;
+            auto cut = partition_pivot(first, last, comp);
+            introsort(cut, last, depth, comp);
+            last = cut;
+        }
+    }
+
+    //A sorting network for N elements: Batcher's odd-even merge sort,
+    //for the next power of two, less the comparators that would only
+    //touch the elements past N.
+    struct comparator {
+        uint8_t a;
+        uint8_t b;
+    };
+
+    template <typename F>
+    constexpr void for_each_comparator(size_t size, F&& emit)
+    {
+        const size_t padded = std::bit_ceil(size);
+        for(size_t p = 1; p < padded; p *= 2) {
+            for(size_t k = p; k >= 1; k /= 2) {
+                for(size_t j = k % p; j + k < padded; j += 2 * k) {
+                    for(size_t i = 0; i < k and i + j + k < size; i++) {
+                        if((i + j) / (2 * p) == (i + j + k) / (2 * p)) emit(i + j, i + j + k);
+                    }
+                }
+            }
+        }
+    }
+
+    constexpr size_t network_size(size_t size)
+    {
+        size_t count = 0;
+        for_each_comparator(size, [&](size_t, size_t) { count++; });
+        return count;
+    }
+
+    template <size_t N>
+    constexpr auto network()
+    {
+        utl::array<comparator,network_size(N)> comparators{};
+        size_t idx = 0;
+        for_each_comparator(N, [&](size_t a, size_t b) {
+            comparators[idx++] = {static_cast<uint8_t>(a), static_cast<uint8_t>(b)};
+        });
+        return comparators;
+    }
+
+    template <typename I, typename C>
+    constexpr void compare_exchange(I a, I b, C& comp)
+    {
+        using value_t = std::remove_cvref_t<decltype(*a)>;
+        if constexpr(std::is_trivially_copyable_v<value_t>) {
+            //written so that it compiles to conditional moves, with no
+            //branch to mispredict
+            const value_t lo = *a;
+            const value_t hi = *b;
+            const bool swap = comp(hi, lo);
+            *a = swap ? hi : lo;
+            *b = swap ? lo : hi;
+        } else {
+            if(comp(*b, *a)) iter_swap(a, b);
+        }
+    }
+
+    template <size_t N, typename I, typename C, size_t... Ks>
+    constexpr void sort_network(I first, C& comp, std::index_sequence<Ks...>)
+    {
+        //unrolled, so that every offset is a constant
+        constexpr auto comparators = network<N>();
+        (compare_exchange(first + comparators[Ks].a, first + comparators[Ks].b, comp), ...);
+    }
+
+    template <size_t N, typename I, typename C>
+    constexpr void sort_network(I first, C& comp)
+    {
+        if constexpr(N > 1) sort_network<N>(first, comp, std::make_index_sequence<network_size(N)>{});
+    }
+
+    //Merges [first, middle) and [middle, last) without a buffer, by
+    //rotating the middle section into place and recursing.
+    template <typename I, typename C>
+    constexpr void merge_in_place(I first, I middle, I last, C& comp)
+    {
+        const size_t left = distance(first, middle);
+        const size_t right = distance(middle, last);
+        if(left == 0 or right == 0) return;
+        if(left + right == 2) {
+            if(comp(*middle, *first)) iter_swap(first, middle);
+            return;
+        }
+        I left_cut;
+        I right_cut;
+        if(left > right) {
+            left_cut = first + left / 2;
+            right_cut = middle;
+            for(size_t count = right; count > 0;) { //lower_bound of *left_cut
+                const size_t half = count / 2;
+                if(comp(*(right_cut + half), *left_cut)) {
+                    right_cut += half + 1;
+                    count -= half + 1;
+                } else {
+                    count = half;
+                }
+            }
+        } else {
+            right_cut = middle + right / 2;
+            left_cut = first;
+            for(size_t count = left; count > 0;) { //upper_bound of *right_cut
+                const size_t half = count / 2;
+                if(not comp(*right_cut, *(left_cut + half))) {
+                    left_cut += half + 1;
+                    count -= half + 1;
+                } else {
+                    count = half;
+                }
+            }
+        }
+        auto new_middle = rotate(left_cut, middle, right_cut);
+        merge_in_place(first, left_cut, new_middle, comp);
+        merge_in_place(new_middle, right_cut, last, comp);
+    }
+
+    //Merges [first, middle) and [middle, last), stably, moving the
+    //shorter of the two into scratch if it fits there.
+    template <typename I, typename T, typename C>
+    constexpr void merge(I first, I middle, I last, utl::span<T> scratch, C& comp)
+    {
+        if(not comp(*middle, *(middle - 1))) return; //already in order
+        const size_t left = distance(first, middle);
+        const size_t right = distance(middle, last);
+        if(left <= right and left <= scratch.size()) {
+            for(size_t idx = 0; idx < left; idx++) scratch[idx] = std::move(*(first + idx));
+            size_t taken = 0;
+            auto out = first;
+            auto next = middle;
+            while(taken < left and next < last) {
+                //ties go to the left, which came first
+                if(comp(*next, scratch[taken])) *out++ = std::move(*next++);
+                else *out++ = std::move(scratch[taken++]);
+            }
+            while(taken < left) *out++ = std::move(scratch[taken++]);
+        } else if(right <= scratch.size()) {
+            for(size_t idx = 0; idx < right; idx++) scratch[idx] = std::move(*(middle + idx));
+            size_t remaining = right;
+            auto out = last;
+            auto next = middle;
+            while(remaining > 0 and next > first) {
+                if(comp(scratch[remaining - 1], *(next - 1))) *--out = std::move(*--next);
+                else *--out = std::move(scratch[--remaining]);
+            }
+            while(remaining > 0) *--out = std::move(scratch[--remaining]);
+        } else {
+            merge_in_place(first, middle, last, comp);
+        }
+    }
+
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+} //namespace detail::algorithm
+
+//Sorts [first, last): an introsort (quicksort, with heapsort if the
+//partitions go badly), finished with an insertion sort. Not stable.
+template <random_access_iterator I, typename C = less>
+constexpr void sort(I first, I last, C comp = {})
+{
+    const size_t size = detail::algorithm::distance(first, last);
+    if(size < 2) return;
+    const auto depth = 2 * static_cast<size_t>(std::bit_width(size) - 1);
+    detail::algorithm::introsort(first, last, depth, comp);
+    detail::algorithm::insertion_sort(first, last, comp);
+}
+
+template <ranges::iterable R, typename C = less>
+constexpr void sort(R&& range, C comp = {})
+{
+    sort(ranges::begin(range), ranges::end(range), comp);
+}
+
+//Arrays of up to 16 elements are sorted with a sorting network: a
+//fixed sequence of branchless compare-and-swaps, unrolled for N.
+template <typename T, size_t N, typename C = less>
+    requires (N <= 16)
+constexpr void sort(utl::array<T,N>& elements, C comp = {})
+{
+    detail::algorithm::sort_network<N>(elements.begin(), comp);
+}
+
+template <typename T, size_t N, typename C = less>
+    requires (N <= 16)
+constexpr void sort(T (&elements)[N], C comp = {}) //NOLINT(cppcoreguidelines-avoid-c-arrays)
+{
+    detail::algorithm::sort_network<N>(&elements[0], comp);
+}
+
+//Sorts [first, last), keeping equal elements in their original order.
+//scratch is working space: with room for half the range, this is a
+//merge sort taking O(n log n) time; with less, the merges that don't
+//fit are done in place, which is slower (O(n log^2 n)) but still
+//correct. An empty scratch is fine.
+template <random_access_iterator I, typename C = less>
+constexpr void stable_sort(I first, I last, utl::span<std::remove_cvref_t<decltype(*first)>> scratch, C comp = {})
+{
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const size_t size = detail::algorithm::distance(first, last);
+    constexpr size_t run = detail::algorithm::small_sort;
+    for(size_t start = 0; start < size; start += run) {
+        detail::algorithm::insertion_sort(first + start, first + utl::min(start + run, size), comp);
+    }
+    for(size_t width = run; width < size; width *= 2) {
+        for(size_t start = 0; start + width < size; start += 2 * width) {
+            detail::algorithm::merge(first + start, first + start + width,
+                first + utl::min(start + 2 * width, size), scratch, comp);
+        }
+    }
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+template <ranges::iterable R, typename C = less>
+constexpr void stable_sort(R&& range, utl::span<range_value_t<R>> scratch, C comp = {})
+{
+    stable_sort(ranges::begin(range), ranges::end(range), scratch, comp);
+}
+
+//Reorders [first, last) so that *nth is the element that would be
+//there if the range were sorted, with nothing greater before it and
+//nothing less after it.
+template <random_access_iterator I, typename C = less>
+constexpr void nth_element(I first, I nth, I last, C comp = {})
+{
+    if(not (nth < last)) return;
+    size_t depth = 2 * static_cast<size_t>(std::bit_width(detail::algorithm::distance(first, last)));
+    while(detail::algorithm::distance(first, last) > 3) {
+        if(depth == 0) {
+            detail::algorithm::heap_sort(first, last, comp);
+            return;
+        }
+        depth--;
+        auto cut = detail::algorithm::partition_pivot(first, last, comp);
+        if(cut < nth or cut == nth) first = cut;
+        else last = cut;
+    }
+    detail::algorithm::insertion_sort(first, last, comp);
+}
+
+template <ranges::iterable R, typename C = less>
+constexpr void nth_element(R&& range, size_t nth, C comp = {})
+{
+    nth_element(ranges::begin(range), ranges::begin(range) + nth, ranges::end(range), comp); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+//The first element that isn't less than value.
+template <random_access_iterator I, typename T, typename C = less>
+constexpr I lower_bound(I first, I last, T const& value, C comp = {})
+{
+    size_t count = detail::algorithm::distance(first, last);
+    while(count > 0) {
+        const size_t half = count / 2;
+        auto middle = first + half; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(comp(*middle, value)) {
+            first = ++middle;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+template <ranges::iterable R, typename T, typename C = less>
+constexpr auto lower_bound(R&& range, T const& value, C comp = {})
+{
+    return lower_bound(ranges::begin(range), ranges::end(range), value, comp);
+}
+
+//The first element that's greater than value.
+template <random_access_iterator I, typename T, typename C = less>
+constexpr I upper_bound(I first, I last, T const& value, C comp = {})
+{
+    size_t count = detail::algorithm::distance(first, last);
+    while(count > 0) {
+        const size_t half = count / 2;
+        auto middle = first + half; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(not comp(value, *middle)) {
+            first = ++middle;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+    return first;
+}
+
+template <ranges::iterable R, typename T, typename C = less>
+constexpr auto upper_bound(R&& range, T const& value, C comp = {})
+{
+    return upper_bound(ranges::begin(range), ranges::end(range), value, comp);
+}
+
+//Moves the elements pred is true for before those it's false for, and
+//returns the first of the latter. Not stable.
+template <random_access_iterator I, typename P>
+constexpr I partition(I first, I last, P pred)
+{
+    while(true) {
+        while(first < last and pred(*first)) ++first;
+        while(first < last and not pred(*(last - 1))) --last; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(not (first < last)) return first;
+        detail::algorithm::iter_swap(first++, --last);
+    }
+}
+
+template <ranges::iterable R, typename P>
+constexpr auto partition(R&& range, P pred)
+{
+    return partition(ranges::begin(range), ranges::end(range), pred);
+}
+
+//The first of the smallest elements, or last if there are none.
+template <random_access_iterator I, typename C = less>
+constexpr I min_element(I first, I last, C comp = {})
+{
+    if(first == last) return last;
+    auto smallest = first;
+    while(++first < last) {
+        if(comp(*first, *smallest)) smallest = first;
+    }
+    return smallest;
+}
+
+template <ranges::iterable R, typename C = less>
+constexpr auto min_element(R&& range, C comp = {})
+{
+    return min_element(ranges::begin(range), ranges::end(range), comp);
+}
+
+//The first of the largest elements, or last if there are none.
+template <random_access_iterator I, typename C = less>
+constexpr I max_element(I first, I last, C comp = {})
+{
+    if(first == last) return last;
+    auto largest = first;
+    while(++first < last) {
+        if(comp(*largest, *first)) largest = first;
+    }
+    return largest;
+}
+
+template <ranges::iterable R, typename C = less>
+constexpr auto max_element(R&& range, C comp = {})
+{
+    return max_element(ranges::begin(range), ranges::end(range), comp);
+}
+
+//Folds the elements into init with op, from first to last.
+template <random_access_iterator I, typename T, typename Op = plus>
+constexpr T accumulate(I first, I last, T init, Op op = {})
+{
+    for(; first < last; ++first) init = op(std::move(init), *first);
+    return init;
+}
+
+template <ranges::iterable R, typename T, typename Op = plus>
+constexpr T accumulate(R&& range, T init, Op op = {})
+{
+    return accumulate(ranges::begin(range), ranges::end(range), std::move(init), op);
+}
 
 } //namespace utl
 
@@ -9,7 +9,8 @@
 
 #include <utl/utl.hh>
 #include <utl/bitset.hh>
-#include <utl/hof/fold.hh>
+#include <utl/array.hh>
+#include <utl/type-list.hh>
 #include <concepts>
 #include <utl/utility.hh>
 
@@ -76,37 +77,64 @@ struct accumulator {
     static constexpr bool found() { return not std::same_as<void,found_t>; }
 };
 
+//Where each of a list of fields lives: fields are packed from bit 0
+//upwards, in the order given. Shared by bitstruct and the byte buffer
+//views, which lay fields out identically.
 template <any_bitfield T, any_bitfield... Ts>
     requires (std::common_with<typename T::tag_t, typename Ts::tag_t> and ...)
-struct bitstruct {
+struct bitfield_layout {
     static constexpr size_t width() { return T::width() + (Ts::width() + ... + 0); }
     using tag_t = std::common_type_t<typename T::tag_t, typename Ts::tag_t...>;
-    
-    uintn_t<width()> value;
-    using value_t = std::remove_reference_t<decltype((value))>;
+
+    static constexpr size_t n_fields = 1 + sizeof...(Ts);
+
+    //Field offsets and tags are tabulated once per layout, so
+    //finding a field doesn't instantiate anything per field.
+    static constexpr utl::array<size_t,n_fields> offsets = []() {
+        constexpr utl::array<size_t,n_fields> widths{{T::width(), Ts::width()...}};
+        utl::array<size_t,n_fields> result{};
+        size_t offset = 0;
+        for(size_t idx = 0; idx < n_fields; idx++) {
+            result[idx] = offset;
+            offset += widths[idx];
+        }
+        return result;
+    }();
+
+    static constexpr utl::array<tag_t,n_fields> tags{{static_cast<tag_t>(T::tag), static_cast<tag_t>(Ts::tag)...}};
 
     template <utl::any_enum auto V>
-    static constexpr auto find_field_by_enum_tag()
+    static constexpr size_t find_field_index()
     {
-        //FIXME: this should be generalized; it's handy   
-        constexpr auto find_accumulate = [](auto&& accum, auto&& item) {
-            using item_t = std::decay_t<decltype(item)>;
-            using accum_t = std::decay_t<decltype(accum)>;
-
-            if constexpr(item_t::template matches_tag<V>()) {
-                return accumulator<accum_t::offset,item_t>{};
-            } else if constexpr(not accum_t::found()) {
-                return accumulator<accum_t::offset + item_t::width(), typename accum_t::found_t>{};
-            } else {
-                return accum;
+        if constexpr(std::same_as<std::decay_t<decltype(V)>,tag_t>) {
+            for(size_t idx = 0; idx < n_fields; idx++) {
+                if(tags[idx] == V) return idx;
             }
-        };
+        }
+        return n_fields;
+    }
 
-        using accum_t = hof::foldl_result_t<tuple<T,Ts...>&, accumulator<0,void>, decltype(find_accumulate)>;
-        // static_assert(accum_t::found(), "bitstruct does not contain a field matching provided tag");
-        
-        return accum_t{};
+    template <utl::any_enum auto V>
+    static constexpr auto find_field_by_enum_tag()
+    {
+        constexpr size_t index = find_field_index<V>();
+        if constexpr(index == n_fields) {
+            return accumulator<width(),void>{};
+        } else {
+            return accumulator<offsets[index],get_t<index,T,Ts...>>{};
+        }
     }
+};
+
+template <any_bitfield T, any_bitfield... Ts>
+    requires (std::common_with<typename T::tag_t, typename Ts::tag_t> and ...)
+struct bitstruct : bitfield_layout<T,Ts...> {
+    using layout_t = bitfield_layout<T,Ts...>;
+    using tag_t = typename layout_t::tag_t;
+    static constexpr size_t width() { return layout_t::width(); }
+
+    uintn_t<width()> value;
+    using value_t = std::remove_reference_t<decltype((value))>;
 
     constexpr bitstruct() = default;
     constexpr bitstruct(bitstruct const&) = default;
@@ -0,0 +1,14 @@
+#pragma once
+
+//Shared by flat_map and static_hash_map.
+
+namespace utl::detail {
+
+//Called by a fixed-capacity map's list constructor when the list has
+//more distinct keys than the map has room for. It isn't constexpr, so
+//a map built at compile time fails to compile there, as the
+//string_switch errors in hash.hh do; it's defined so that a map built
+//at runtime, which drops the extra keys, still links.
+inline void fixed_map_too_many_entries() {}
+
+} //namespace utl::detail
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <concepts>
 #include <utl/bits/format_options.hh>
 
 namespace utl::fmt {
@@ -32,6 +33,47 @@ struct output_t final : public virtual output {
 template <typename F>
 output_t(F&) -> output_t<F>;
 
+//Anything with push_back(char), which format_into appends to rather
+//than overwriting.
+template <typename C>
+concept appendable = requires(C& container, char c) {
+    container.push_back(c);
+};
+
+//Writes straight into an appendable container, handing whole runs of
+//text to its append() when it has one. A container whose push_back
+//reports running out of room (static_string, string_builder) stops
+//itself; one whose push_back assumes there's room (static_vector) is
+//checked with full() first, and the rest of the text is dropped.
+template <appendable C>
+struct append_output_t final : public virtual output {
+    C& container;
+    append_output_t(C& c) : container{c} {}
+    void operator()(char c) final
+    {
+        if constexpr(requires { { container.push_back(c) } -> std::same_as<void>; container.full(); }) {
+            if(container.full()) return;
+        }
+        //a container of bytes takes the char's bits as they are
+        if constexpr(requires { typename C::value_t; }) {
+            container.push_back(static_cast<typename C::value_t>(c));
+        } else {
+            container.push_back(c);
+        }
+    }
+    void operator()(utl::string_view view) final
+    {
+        if constexpr(requires { container.append(view); }) {
+            container.append(view);
+        } else {
+            for(char c : view) (*this)(c);
+        }
+    }
+};
+
+template <appendable C>
+append_output_t(C&) -> append_output_t<C>;
+
 // output the specified string. could be in reverse.
 // if the string represents a number type, ignore precision (it either doesn't apply or has a different meaning)
 // if it isn't a number type, precision is the maximum number of chars to take from the field value.
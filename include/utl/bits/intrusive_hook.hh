@@ -0,0 +1,56 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <type_traits>
+#include <utl/utl.hh>
+
+//How the intrusive containers get from an element to its hook and
+//back. A hook is either a base class of the element (the container's
+//Member parameter is nullptr) or a data member of it (Member is a
+//pointer to that member).
+//
+//For a member hook, getting back to the element means subtracting the
+//hook's offset. The offset is read out of the member pointer, which on
+//the Itanium and ARM C++ ABIs is exactly that offset; it's a constant
+//after optimization, with no object needed to measure it.
+
+namespace utl::detail::intrusive {
+
+template <typename T, typename Hook, auto Member>
+struct hook_traits {
+    static_assert(std::is_member_object_pointer_v<decltype(Member)>,
+        "an intrusive container's hook must be a base class or a data member of its element");
+
+    //converted, so a hook declared in a base of T is offset from T
+    static constexpr Hook T::* member = Member;
+    static_assert(sizeof(member) == sizeof(std::ptrdiff_t),
+        "member pointers aren't plain offsets on this ABI");
+
+    static constexpr Hook& to_hook(T& element) { return element.*member; }
+    static constexpr Hook const& to_hook(T const& element) { return element.*member; }
+
+    static T& to_element(Hook& hook)
+    {
+        const auto offset = std::bit_cast<std::ptrdiff_t>(member);
+        return *reinterpret_cast<T*>(reinterpret_cast<char*>(&hook) - offset); //NOLINT(cppcoreguidelines-pro-type-reinterpret-cast,cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    static T const& to_element(Hook const& hook)
+    {
+        return to_element(const_cast<Hook&>(hook)); //NOLINT(cppcoreguidelines-pro-type-const-cast)
+    }
+};
+
+template <typename T, typename Hook>
+struct hook_traits<T,Hook,nullptr> {
+    static_assert(std::is_base_of_v<Hook,T>,
+        "an element of an intrusive container without a member hook must derive from the hook");
+
+    static constexpr Hook& to_hook(T& element) { return element; }
+    static constexpr Hook const& to_hook(T const& element) { return element; }
+    static constexpr T& to_element(Hook& hook) { return static_cast<T&>(hook); }
+    static constexpr T const& to_element(Hook const& hook) { return static_cast<T const&>(hook); }
+};
+
+} //namespace utl::detail::intrusive
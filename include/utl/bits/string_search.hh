@@ -0,0 +1,222 @@
+#pragma once
+
+#include <stdint.h>
+#include <bit>
+#include <utl/utl.hh>
+
+//Substring search shared by string_view and string. Everything works
+//on pointer and length pairs so that it can be used from string_view
+//itself.
+//
+//During constant evaluation the search is a plain loop (there's no
+//recursion, so long strings don't hit the depth limit). At runtime:
+//  - a one character needle is a memchr
+//  - needles up to long_needle characters are found a word at a time:
+//    each word of candidate positions is tested for a matching first
+//    *and* last character at once, and only positions that pass both
+//    are compared in full
+//  - longer needles use Boyer-Moore-Horspool, which skips ahead by up
+//    to the needle's length after each mismatch
+
+namespace utl::search {
+
+inline constexpr size_t long_needle = 32;
+
+using word_t = uintptr_t;
+inline constexpr size_t word_size = sizeof(word_t);
+inline constexpr word_t ones = ~word_t{0} / 0xFF; //0x0101...
+inline constexpr word_t low7 = ones * 0x7F;       //0x7F7F...
+
+constexpr bool equal(const char* lhs, const char* rhs, size_t count)
+{
+    for(size_t idx = 0; idx < count; idx++) {
+        if(lhs[idx] != rhs[idx]) return false; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return true;
+}
+
+constexpr size_t find_constant(const char* hay, size_t hay_len, const char* needle, size_t needle_len, size_t pos)
+{
+    for(size_t idx = pos; idx + needle_len <= hay_len; idx++) {
+        if(equal(hay + idx, needle, needle_len)) return idx; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return npos;
+}
+
+inline word_t load_word(const char* ptr)
+{
+    word_t word{};
+    __builtin_memcpy(&word, ptr, sizeof(word));
+    //put the first character in the lowest byte
+    if constexpr(std::endian::native == std::endian::big) {
+        if constexpr(sizeof(word) == 8) return __builtin_bswap64(word);
+        else return __builtin_bswap32(word);
+    }
+    return word;
+}
+
+//0x80 in every byte of word that's zero, and nothing else
+inline word_t zero_bytes(word_t word)
+{
+    return ~(((word & low7) + low7) | word | low7);
+}
+
+inline size_t find_char(const char* hay, size_t hay_len, char c, size_t pos)
+{
+    const void* found = __builtin_memchr(hay + pos, c, hay_len - pos); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if(found == nullptr) return npos;
+    return static_cast<size_t>(static_cast<const char*>(found) - hay);
+}
+
+inline size_t find_short(const char* hay, size_t hay_len, const char* needle, size_t needle_len, size_t pos)
+{
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const word_t first = ones * static_cast<uint8_t>(needle[0]);
+    const word_t last = ones * static_cast<uint8_t>(needle[needle_len - 1]);
+    size_t idx = pos;
+    //the word of last characters for the candidates at idx reads up
+    //to hay[idx + needle_len - 1 + word_size - 1]
+    while(idx + needle_len - 1 + word_size <= hay_len) {
+        const word_t matches = zero_bytes(load_word(hay + idx) ^ first)
+            & zero_bytes(load_word(hay + idx + needle_len - 1) ^ last);
+        for(word_t bits = matches; bits != 0; bits &= bits - 1) {
+            const auto candidate = idx + static_cast<size_t>(std::countr_zero(bits)) / 8;
+            if(__builtin_memcmp(hay + candidate + 1, needle + 1, needle_len - 2) == 0) return candidate;
+        }
+        idx += word_size;
+    }
+    for(; idx + needle_len <= hay_len; idx++) {
+        if(hay[idx] == needle[0] and __builtin_memcmp(hay + idx, needle, needle_len) == 0) return idx;
+    }
+    return npos;
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+inline size_t find_long(const char* hay, size_t hay_len, const char* needle, size_t needle_len, size_t pos)
+{
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index)
+    //shifts are capped at 255 to keep the table small; shifting less
+    //than the full distance is always safe
+    uint8_t skip[256]; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    const auto max_skip = static_cast<uint8_t>(needle_len < 255 ? needle_len : 255);
+    __builtin_memset(skip, max_skip, sizeof(skip));
+    for(size_t idx = needle_len > 255 ? needle_len - 255 : 0; idx < needle_len - 1; idx++) {
+        skip[static_cast<uint8_t>(needle[idx])] = static_cast<uint8_t>(needle_len - 1 - idx);
+    }
+    const char last = needle[needle_len - 1];
+    for(size_t idx = pos; idx + needle_len <= hay_len;) {
+        const char tail = hay[idx + needle_len - 1];
+        if(tail == last and __builtin_memcmp(hay + idx, needle, needle_len - 1) == 0) return idx;
+        idx += skip[static_cast<uint8_t>(tail)];
+    }
+    return npos;
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index)
+}
+
+//A set of characters, for strpbrk/strspn style searches. Membership
+//is a bit test, and sets of up to small_set characters can also be
+//searched for a word at a time: each word of the string is compared
+//against a broadcast of every member at once.
+inline constexpr size_t small_set = 4;
+
+class char_set {
+    uint32_t m_bits[8]{}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    word_t m_broadcast[small_set]{}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    bool m_broadcastable = false; //false if the set is too big
+
+public:
+    constexpr char_set() = default;
+
+    constexpr char_set(const char* set, size_t set_len)
+    {
+        //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index)
+        for(size_t idx = 0; idx < set_len; idx++) {
+            const auto c = static_cast<uint8_t>(set[idx]);
+            m_bits[c / 32] |= uint32_t{1} << (c % 32);
+        }
+        if(set_len > 0 and set_len <= small_set) {
+            //unused slots repeat the last member, so members() can
+            //always test all of them
+            for(size_t idx = 0; idx < small_set; idx++) {
+                m_broadcast[idx] = ones * static_cast<uint8_t>(set[idx < set_len ? idx : set_len - 1]);
+            }
+            m_broadcastable = true;
+        }
+        //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    [[nodiscard]] constexpr bool contains(char c) const
+    {
+        const auto byte = static_cast<uint8_t>(c);
+        return (m_bits[byte / 32] >> (byte % 32)) & 1; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    //0x80 in each byte of word that's in the set. Only valid if the
+    //set is broadcastable().
+    [[nodiscard]] word_t members(word_t word) const
+    {
+        //a byte is in the set if it's zero in any of the xors; this is
+        //zero_bytes() with the final steps shared between members
+        word_t all = ~word_t{0};
+        for(auto broadcast : m_broadcast) {
+            const auto diff = word ^ broadcast;
+            all &= ((diff & low7) + low7) | diff;
+        }
+        return ~(all | low7);
+    }
+
+    [[nodiscard]] constexpr bool broadcastable() const { return m_broadcastable; }
+};
+
+//The position of the first character at or after pos that is (or,
+//with Match false, isn't) in set, or npos. Only the search for a
+//member goes a word at a time; runs of members (such as the spaces
+//between tokens) are usually too short for it to pay off.
+template <bool Match = true>
+constexpr size_t find_any(const char* hay, size_t hay_len, char_set const& set, size_t pos = 0)
+{
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    size_t idx = pos;
+    if constexpr(Match) {
+        if(not std::is_constant_evaluated() and set.broadcastable()) {
+            for(; idx + word_size <= hay_len; idx += word_size) {
+                const auto matches = set.members(load_word(hay + idx));
+                if(matches != 0) return idx + static_cast<size_t>(std::countr_zero(matches)) / 8;
+            }
+        }
+    }
+    for(; idx < hay_len; idx++) {
+        if(set.contains(hay[idx]) == Match) return idx;
+    }
+    return npos;
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+//The position of the first occurrence of needle in hay at or after
+//pos, or npos.
+constexpr size_t find(const char* hay, size_t hay_len, const char* needle, size_t needle_len, size_t pos = 0)
+{
+    if(pos > hay_len or needle_len > hay_len - pos) return npos;
+    if(needle_len == 0) return pos;
+    if(std::is_constant_evaluated()) return find_constant(hay, hay_len, needle, needle_len, pos);
+    if(needle_len == 1) return find_char(hay, hay_len, needle[0], pos);
+    if(needle_len < long_needle) return find_short(hay, hay_len, needle, needle_len, pos);
+    return find_long(hay, hay_len, needle, needle_len, pos);
+}
+
+//The position of the last occurrence of needle in hay that starts at
+//or before pos, or npos.
+constexpr size_t rfind(const char* hay, size_t hay_len, const char* needle, size_t needle_len, size_t pos = npos)
+{
+    if(needle_len > hay_len) return npos;
+    const size_t last = hay_len - needle_len;
+    if(pos > last) pos = last;
+    if(needle_len == 0) return pos;
+    for(size_t idx = pos + 1; idx-- > 0;) {
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(hay[idx] == needle[0] and equal(hay + idx + 1, needle + 1, needle_len - 1)) return idx;
+    }
+    return npos;
+}
+
+} //namespace utl::search
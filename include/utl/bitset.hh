@@ -8,6 +8,7 @@
 #pragma once
 #include <utl/utl.hh>
 #include <utl/integer.hh>
+#include <utl/array.hh>
 #include <bit>
 
 namespace utl {
@@ -81,15 +82,20 @@ class bitspan {
         using word_t = W;
         using underlying_t = T;
         static constexpr size_t bitset_width = utl::integer::width<underlying_t>();
-        static constexpr std::decay_t<word_t> bitset_mask = (1 << bitset_width) - 1;
+        using word_value_t = std::decay_t<word_t>;
+        //shifting a 1 up by the width overflows for fields of 32 bits or more
+        static constexpr word_value_t bitset_mask = static_cast<word_value_t>(
+            static_cast<word_value_t>(~word_value_t{0}) >> (utl::integer::width<word_value_t>() - bitset_width));
 
         word_t& m_word;
 
         constexpr auto& set_value(auto&& value)
         {
-            const word_t set_mask = word_t{value.value()} << O;
-            const word_t clear_mask = (~set_mask) & (bitset_mask << O);
-            m_word = (m_word | set_mask) & (~clear_mask);
+            //the casts undo integer promotion for words narrower than int
+            using value_t = std::decay_t<word_t>;
+            const auto set_mask = static_cast<value_t>(value_t{value.value()} << O);
+            const auto clear_mask = static_cast<value_t>(static_cast<value_t>(~set_mask) & (bitset_mask << O));
+            m_word = static_cast<value_t>((m_word | set_mask) & static_cast<value_t>(~clear_mask));
             return *this;
         }
     public:
@@ -125,4 +131,212 @@ class bitspan {
 
 static_assert(any_bitset<bitspan<uint32_t,uint8_t,0>>);
 
+//A fixed-size set of Bits bits, for when one integer isn't enough:
+//allocation maps, pending interrupt sets, key states. Bits are stored
+//in machine words, least significant first, and everything that
+//scans (count, find, iteration) works a word at a time. Bits past
+//the end of the last word are always kept clear.
+template <size_t Bits>
+class bitset_n {
+public:
+    using word_t = uintptr_t;
+    static constexpr size_t word_width = sizeof(word_t) * 8;
+    static constexpr size_t n_words = (Bits + word_width - 1) / word_width;
+    //returned by the find functions when there's no such bit
+    static constexpr size_t npos = Bits;
+
+private:
+    static constexpr size_t tail_bits = Bits % word_width;
+    static constexpr word_t tail_mask = tail_bits == 0 ? ~word_t{0} : (word_t{1} << tail_bits) - 1;
+
+    utl::array<word_t,n_words> m_words{};
+
+    static constexpr word_t bit_mask(size_t index) { return word_t{1} << (index % word_width); }
+
+    constexpr void trim()
+    {
+        if constexpr(n_words > 0) m_words[n_words - 1] &= tail_mask;
+    }
+
+    //first set bit at or after index in the words produced by read
+    template <typename F>
+    [[nodiscard]] constexpr size_t find_from(size_t index, F&& read) const
+    {
+        if(index >= Bits) return npos;
+        size_t word = index / word_width;
+        word_t bits = read(word) & (~word_t{0} << (index % word_width));
+        while(true) {
+            if(bits != 0) {
+                const auto found = word * word_width + static_cast<size_t>(std::countr_zero(bits));
+                return found < Bits ? found : npos;
+            }
+            if(++word == n_words) return npos;
+            bits = read(word);
+        }
+    }
+
+public:
+    constexpr bitset_n() = default;
+
+    static constexpr size_t size() { return Bits; }
+
+    [[nodiscard]] constexpr bool test(size_t index) const
+    {
+        return (m_words[index / word_width] & bit_mask(index)) != 0;
+    }
+
+    constexpr bitset_n& set(size_t index)
+    {
+        m_words[index / word_width] |= bit_mask(index);
+        return *this;
+    }
+
+    constexpr bitset_n& set(size_t index, bool value)
+    {
+        return value ? set(index) : clear(index);
+    }
+
+    constexpr bitset_n& clear(size_t index)
+    {
+        m_words[index / word_width] &= ~bit_mask(index);
+        return *this;
+    }
+
+    constexpr bitset_n& flip(size_t index)
+    {
+        m_words[index / word_width] ^= bit_mask(index);
+        return *this;
+    }
+
+    constexpr bitset_n& set_all()
+    {
+        for(auto& word : m_words) word = ~word_t{0};
+        trim();
+        return *this;
+    }
+
+    constexpr bitset_n& clear_all()
+    {
+        for(auto& word : m_words) word = 0;
+        return *this;
+    }
+
+    [[nodiscard]] constexpr size_t count() const
+    {
+        size_t total = 0;
+        for(auto word : m_words) total += static_cast<size_t>(std::popcount(word));
+        return total;
+    }
+
+    [[nodiscard]] constexpr bool any() const
+    {
+        for(auto word : m_words) if(word != 0) return true;
+        return false;
+    }
+
+    [[nodiscard]] constexpr bool none() const { return not any(); }
+    [[nodiscard]] constexpr bool all() const { return count() == Bits; }
+
+    [[nodiscard]] constexpr size_t find_first_set() const { return find_next_set(0); }
+
+    //The first set bit at or after index.
+    [[nodiscard]] constexpr size_t find_next_set(size_t index) const
+    {
+        return find_from(index, [this](size_t word) { return m_words[word]; });
+    }
+
+    [[nodiscard]] constexpr size_t find_first_clear() const { return find_next_clear(0); }
+
+    //The first clear bit at or after index.
+    [[nodiscard]] constexpr size_t find_next_clear(size_t index) const
+    {
+        return find_from(index, [this](size_t word) { return static_cast<word_t>(~m_words[word]); });
+    }
+
+    constexpr bitset_n& operator&=(bitset_n const& other)
+    {
+        for(size_t idx = 0; idx < n_words; idx++) m_words[idx] &= other.m_words[idx];
+        return *this;
+    }
+
+    constexpr bitset_n& operator|=(bitset_n const& other)
+    {
+        for(size_t idx = 0; idx < n_words; idx++) m_words[idx] |= other.m_words[idx];
+        return *this;
+    }
+
+    constexpr bitset_n& operator^=(bitset_n const& other)
+    {
+        for(size_t idx = 0; idx < n_words; idx++) m_words[idx] ^= other.m_words[idx];
+        return *this;
+    }
+
+    [[nodiscard]] constexpr bitset_n operator~() const
+    {
+        bitset_n result{};
+        for(size_t idx = 0; idx < n_words; idx++) result.m_words[idx] = ~m_words[idx];
+        result.trim();
+        return result;
+    }
+
+    [[nodiscard]] friend constexpr bitset_n operator&(bitset_n lhs, bitset_n const& rhs) { return lhs &= rhs; }
+    [[nodiscard]] friend constexpr bitset_n operator|(bitset_n lhs, bitset_n const& rhs) { return lhs |= rhs; }
+    [[nodiscard]] friend constexpr bitset_n operator^(bitset_n lhs, bitset_n const& rhs) { return lhs ^= rhs; }
+
+    [[nodiscard]] friend constexpr bool operator==(bitset_n const& lhs, bitset_n const& rhs)
+    {
+        for(size_t idx = 0; idx < n_words; idx++) {
+            if(lhs.m_words[idx] != rhs.m_words[idx]) return false;
+        }
+        return true;
+    }
+
+    [[nodiscard]] constexpr utl::array<word_t,n_words> const& words() const { return m_words; }
+
+    //Iterates over the indices of the set bits, in ascending order.
+    //Each step clears the lowest bit of a copy of the current word, so
+    //the cost is per set bit plus per word, never per bit.
+    class iterator {
+        bitset_n const* m_set;
+        size_t m_word;
+        word_t m_bits;
+
+        constexpr void skip_empty()
+        {
+            while(m_bits == 0 and m_word < n_words) {
+                if(++m_word < n_words) m_bits = m_set->m_words[m_word];
+            }
+        }
+
+    public:
+        constexpr iterator(bitset_n const* set, size_t word)
+            : m_set{set}, m_word{word}, m_bits{word < n_words ? set->m_words[word] : 0}
+        {
+            skip_empty();
+        }
+
+        constexpr size_t operator*() const
+        {
+            return m_word * word_width + static_cast<size_t>(std::countr_zero(m_bits));
+        }
+
+        constexpr iterator& operator++()
+        {
+            m_bits &= m_bits - 1;
+            skip_empty();
+            return *this;
+        }
+
+        constexpr iterator operator++(int) { auto previous = *this; ++*this; return previous; }
+
+        constexpr bool operator==(iterator const& other) const
+        {
+            return m_word == other.m_word and m_bits == other.m_bits;
+        }
+    };
+
+    [[nodiscard]] constexpr iterator begin() const { return {this, 0}; }
+    [[nodiscard]] constexpr iterator end() const { return {this, n_words}; }
+};
+
 } //namespace utl
@@ -0,0 +1,199 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <bit>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/bitfield.hh>
+#include <utl/result.hh>
+#include <utl/span.hh>
+
+namespace utl {
+
+//Bitstreams are packed least significant bit first, one record after
+//another with no padding, so a record's bits land in the stream in
+//the same order they sit in its bitstruct. Whole 64-bit words are
+//stored little endian.
+
+namespace detail {
+    constexpr uint64_t low_bits(size_t width)
+    {
+        return width >= 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    }
+
+    inline uint64_t to_little_endian(uint64_t word)
+    {
+        if constexpr(std::endian::native == std::endian::big) return __builtin_bswap64(word);
+        return word;
+    }
+} //namespace detail
+
+//Packs values into a byte buffer through a 64-bit accumulator, which
+//is only ever stored to memory a whole word at a time; nothing in the
+//buffer is read back or modified once written.
+class bitstream_writer {
+    utl::span<uint8_t> m_out;
+    size_t m_flushed = 0; //bytes of m_out already written
+    uint64_t m_accumulator = 0;
+    size_t m_pending = 0; //valid low bits in m_accumulator
+    bool m_overflowed = false;
+
+    void flush_word()
+    {
+        const auto word = detail::to_little_endian(m_accumulator);
+        __builtin_memcpy(m_out.data() + m_flushed, &word, sizeof(word)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        m_flushed += sizeof(word);
+    }
+
+public:
+    explicit bitstream_writer(utl::span<uint8_t> out) : m_out{out} {}
+
+    //Bits written so far, including any not yet flushed.
+    [[nodiscard]] size_t bits() const { return m_flushed * 8 + m_pending; }
+    [[nodiscard]] size_t capacity() const { return m_out.size() * 8; }
+    [[nodiscard]] bool overflowed() const { return m_overflowed; }
+
+    //Appends the low width bits of value (width <= 64). Anything that
+    //doesn't fit is dropped and the writer marked as overflowed.
+    void write(uint64_t value, size_t width)
+    {
+        if(width == 0) return;
+        if(bits() + width > capacity()) {
+            m_overflowed = true;
+            return;
+        }
+        value &= detail::low_bits(width);
+        m_accumulator |= value << m_pending;
+        if(m_pending + width < 64) {
+            m_pending += width;
+            return;
+        }
+        //the accumulator is full. The capacity check above means a
+        //whole word always fits here.
+        const auto used = 64 - m_pending;
+        const auto spilled = width - used;
+        flush_word();
+        m_accumulator = spilled == 0 ? 0 : value >> used;
+        m_pending = spilled;
+    }
+
+    template <any_bitstruct T>
+    void write(T const& record)
+    {
+        constexpr size_t width = std::decay_t<T>::width();
+        if constexpr(width <= 64) {
+            write(static_cast<uint64_t>(record.value), width);
+        } else {
+            static_assert(width <= 128, "records wider than 128 bits aren't supported");
+            write(static_cast<uint64_t>(record.value), 64);
+            write(static_cast<uint64_t>(record.value >> 64), width - 64);
+        }
+    }
+
+    //Appends every record in a range.
+    template <typename R>
+        requires requires(R const& r) { { *r.begin() } -> any_bitstruct; }
+    void write_all(R const& records)
+    {
+        for(auto const& record : records) write(record);
+    }
+
+    //Stores whatever is left in the accumulator, padding the final
+    //byte with zeroes. Returns the number of bytes used, or
+    //errc::out_of_bounds if anything was dropped.
+    result<size_t> finish()
+    {
+        finish_bytes();
+        if(m_overflowed) return errc::out_of_bounds;
+        return m_flushed;
+    }
+
+private:
+    void finish_bytes()
+    {
+        while(m_pending > 0) {
+            m_out[m_flushed++] = static_cast<uint8_t>(m_accumulator);
+            m_accumulator = m_pending > 8 ? m_accumulator >> 8 : 0;
+            m_pending = m_pending > 8 ? m_pending - 8 : 0;
+        }
+    }
+};
+
+//Unpacks a stream written by bitstream_writer. Each read is one
+//unaligned 64-bit load from the current byte, except near the end of
+//the buffer.
+class bitstream_reader {
+    utl::span<const uint8_t> m_in;
+    size_t m_position = 0; //in bits
+    bool m_overflowed = false;
+
+    [[nodiscard]] uint64_t load(size_t byte) const
+    {
+        uint64_t word = 0;
+        const auto available = m_in.size() - byte;
+        __builtin_memcpy(&word, m_in.data() + byte, available < sizeof(word) ? available : sizeof(word)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return detail::to_little_endian(word);
+    }
+
+public:
+    explicit bitstream_reader(utl::span<const uint8_t> in) : m_in{in} {}
+
+    [[nodiscard]] size_t position() const { return m_position; }
+    [[nodiscard]] size_t remaining() const { return m_in.size() * 8 - m_position; }
+    [[nodiscard]] bool overflowed() const { return m_overflowed; }
+
+    //Reads the next width bits (width <= 64). Reading past the end
+    //returns zero and marks the reader as overflowed.
+    uint64_t read(size_t width)
+    {
+        if(width == 0) return 0;
+        if(width > remaining()) {
+            m_overflowed = true;
+            m_position = m_in.size() * 8;
+            return 0;
+        }
+        //a single load covers up to 57 bits at any alignment
+        constexpr size_t max_single = 57;
+        if(width > max_single) {
+            const auto low = read(32);
+            return low | (read(width - 32) << 32);
+        }
+        const auto shift = m_position % 8;
+        const auto value = (load(m_position / 8) >> shift) & detail::low_bits(width);
+        m_position += width;
+        return value;
+    }
+
+    template <any_bitstruct T>
+    T read()
+    {
+        using value_t = typename std::decay_t<T>::value_t;
+        constexpr size_t width = std::decay_t<T>::width();
+        T record{};
+        if constexpr(width <= 64) {
+            record.value = static_cast<value_t>(read(width));
+        } else {
+            static_assert(width <= 128, "records wider than 128 bits aren't supported");
+            const auto low = static_cast<value_t>(read(64));
+            record.value = static_cast<value_t>(low | static_cast<value_t>(static_cast<value_t>(read(width - 64)) << 64));
+        }
+        return record;
+    }
+
+    //Fills a range of records, in order.
+    template <typename R>
+        requires requires(R& r) { { *r.begin() } -> any_bitstruct; }
+    void read_all(R&& records)
+    {
+        for(auto& record : records) record = read<std::remove_cvref_t<decltype(record)>>();
+    }
+};
+
+} //namespace utl
@@ -0,0 +1,197 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <bit>
+#include <concepts>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/bitfield.hh>
+#include <utl/result.hh>
+#include <utl/span.hh>
+
+namespace utl {
+
+//A field of a bitstruct_view. Only the bytes the field overlaps are
+//touched: they're copied into a word, byte swapped if the buffer isn't
+//in native order, then shifted and masked. The byte count is a
+//constant, so the copy becomes one or two unaligned loads.
+template <auto N, typename Byte, std::endian E, size_t Bytes, typename T, size_t O>
+class bitfield_bytes_view {
+    static constexpr size_t field_width = utl::integer::width<T>();
+    static_assert(O % 8 + field_width <= 64, "a field may span at most 8 bytes");
+
+    static constexpr size_t first_byte = O / 8;
+    static constexpr size_t n_bytes = (O % 8 + field_width + 7) / 8;
+    static constexpr size_t shift = O % 8;
+    static constexpr uint64_t mask = field_width == 64 ? ~uint64_t{0} : (uint64_t{1} << field_width) - 1;
+    //in a big endian buffer the value's least significant byte is last
+    static constexpr size_t base = E == std::endian::little ? first_byte : Bytes - first_byte - n_bytes;
+
+    Byte* m_bytes;
+
+    static constexpr size_t significance(size_t idx)
+    {
+        return 8 * (E == std::endian::little ? idx : n_bytes - 1 - idx);
+    }
+
+    //converts between the field's bytes, loaded into the low-addressed
+    //end of a word, and their value
+    static constexpr uint64_t from_memory(uint64_t word)
+    {
+        constexpr size_t unused = 64 - 8 * n_bytes;
+        if constexpr(E == std::endian::native) {
+            return E == std::endian::little ? word : word >> unused;
+        } else {
+            return E == std::endian::little ? __builtin_bswap64(word) : __builtin_bswap64(word) >> unused;
+        }
+    }
+
+    static constexpr uint64_t to_memory(uint64_t value)
+    {
+        constexpr size_t unused = 64 - 8 * n_bytes;
+        if constexpr(E == std::endian::native) {
+            return E == std::endian::little ? value : value << unused;
+        } else {
+            return E == std::endian::little ? __builtin_bswap64(value) : __builtin_bswap64(value << unused);
+        }
+    }
+
+    [[nodiscard]] constexpr uint64_t load() const
+    {
+        uint64_t word = 0;
+        if(std::is_constant_evaluated()) {
+            for(size_t idx = 0; idx < n_bytes; idx++) {
+                word |= uint64_t{m_bytes[base + idx]} << significance(idx); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+            return word;
+        }
+        __builtin_memcpy(&word, m_bytes + base, n_bytes); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return from_memory(word);
+    }
+
+    constexpr void store(uint64_t value) const
+    {
+        if(std::is_constant_evaluated()) {
+            for(size_t idx = 0; idx < n_bytes; idx++) {
+                m_bytes[base + idx] = static_cast<uint8_t>(value >> significance(idx)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+            return;
+        }
+        const uint64_t word = to_memory(value);
+        __builtin_memcpy(m_bytes + base, &word, n_bytes); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+public:
+    using tag_t = std::decay_t<decltype(N)>;
+    using value_t = T;
+    static constexpr auto tag = N;
+
+    constexpr explicit bitfield_bytes_view(Byte* bytes) : m_bytes{bytes} {}
+
+    static constexpr size_t offset() { return O; }
+    static constexpr size_t width() { return field_width; }
+
+    template <utl::any_enum auto V>
+    static constexpr bool matches_tag()
+    {
+        if constexpr(std::same_as<tag_t,std::decay_t<decltype(V)>>) {
+            return V == tag;
+        }
+        return false;
+    }
+
+    [[nodiscard]] constexpr T value() const
+    {
+        return static_cast<T>((load() >> shift) & mask);
+    }
+
+    explicit constexpr operator bitset<T>() const
+    {
+        return {value()};
+    }
+
+    constexpr auto const& operator=(T const& value) const
+        requires (not std::is_const_v<Byte>)
+    {
+        const auto bits = (static_cast<uint64_t>(value) & mask) << shift;
+        store((load() & ~(mask << shift)) | bits);
+        return *this;
+    }
+
+    constexpr auto const& operator=(bitset<T> const& value) const
+        requires (not std::is_const_v<Byte>)
+    {
+        return operator=(value.value());
+    }
+};
+
+//Overlays a bitstruct layout on a buffer of bytes holding a
+//width()-bit integer in byte order E, so fields of a received frame
+//can be read (or, for a mutable buffer, written) in place rather than
+//copied and byte swapped into a bitstruct first. Fields are laid out
+//exactly as in bitstruct<T,Ts...>, and looked up the same way, with
+//get_field<V>(view).
+template <typename Byte, std::endian E, any_bitfield T, any_bitfield... Ts>
+    requires (std::same_as<std::remove_const_t<Byte>,uint8_t>)
+class basic_bitstruct_view : public bitfield_layout<T,Ts...> {
+    Byte* m_bytes;
+
+public:
+    using layout_t = bitfield_layout<T,Ts...>;
+    using tag_t = typename layout_t::tag_t;
+    using byte_t = Byte;
+    static constexpr std::endian endianness = E;
+
+    static constexpr size_t width() { return layout_t::width(); }
+    static constexpr size_t size() { return (width() + 7) / 8; }
+
+    //The buffer must hold at least size() bytes; see overlay() for a
+    //checked version.
+    constexpr explicit basic_bitstruct_view(utl::span<Byte> bytes) : m_bytes{bytes.data()} {}
+
+    [[nodiscard]] static constexpr result<basic_bitstruct_view> overlay(utl::span<Byte> bytes)
+    {
+        if(bytes.size() < size()) return errc::out_of_bounds;
+        return basic_bitstruct_view{bytes};
+    }
+
+    [[nodiscard]] constexpr Byte* data() const { return m_bytes; }
+};
+
+template <std::endian E, any_bitfield T, any_bitfield... Ts>
+using bitstruct_view = basic_bitstruct_view<const uint8_t,E,T,Ts...>;
+
+template <std::endian E, any_bitfield T, any_bitfield... Ts>
+using mutable_bitstruct_view = basic_bitstruct_view<uint8_t,E,T,Ts...>;
+
+namespace detail {
+    template <typename T>
+    struct is_bitstruct_view : std::false_type {};
+
+    template <typename Byte, std::endian E, typename... Ts>
+    struct is_bitstruct_view<basic_bitstruct_view<Byte,E,Ts...>> : std::true_type {};
+} //namespace detail
+
+template <typename T>
+concept any_bitstruct_view = detail::is_bitstruct_view<std::remove_cvref_t<T>>::value;
+
+template <utl::any_enum auto V>
+constexpr auto get_field(any_bitstruct_view auto const& view)
+{
+    using view_t = std::remove_cvref_t<decltype(view)>;
+    using accum_t = decltype(view_t::template find_field_by_enum_tag<V>());
+    static_assert(accum_t::found(), "the view has no field with this tag");
+    using field_value_t = typename accum_t::found_t::value_t;
+
+    return bitfield_bytes_view<V,typename view_t::byte_t,view_t::endianness,view_t::size(),
+        field_value_t,accum_t::offset>{view.data()};
+}
+
+} //namespace utl
@@ -18,6 +18,8 @@ namespace utl {
 enum class errc : int32_t {
     success,
     out_of_bounds,
+    busy,
+    timeout,
     unknown
 };
 
@@ -50,6 +52,10 @@ namespace error {
                 return "success"_sv;
             case errc::out_of_bounds:
                 return "index out of bounds"_sv;
+            case errc::busy:
+                return "resource busy"_sv;
+            case errc::timeout:
+                return "operation timed out"_sv;
             case errc::unknown:
             default:
                 return "unknown generic error"_sv;
@@ -0,0 +1,224 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+#include <utl/utl.hh>
+#include <utl/error.hh>
+#include <utl/result.hh>
+#include <utl/array.hh>
+#include <utl/algorithm.hh>
+#include <utl/span.hh>
+#include <utl/tuple.hh>
+#include <utl/bits/fixed_map.hh>
+
+namespace utl {
+
+//A map with room for N entries, kept sorted by key: lookups are a
+//binary search, and there's no allocation. Keys and values are kept in
+//separate arrays, so the search only touches keys, and a scan over
+//keys() or values() is a scan over contiguous memory.
+//
+//    constexpr utl::flat_map<uint16_t,uint32_t,4> baud_divisors{
+//        {96, 625}, {192, 312}, {384, 156}, {1152, 52}};
+//    if(auto divisor = baud_divisors.find(rate)) ...
+//
+//Both arrays are default constructed up front, and entries are moved
+//along them by assignment, so K and V must be default constructible
+//and assignable. Insertion and erasure shift every entry after the
+//position, so this suits tables that are built once (or rarely
+//change) and are looked up often; see static_hash_map for tables that
+//churn.
+template <typename K, typename V, size_t N>
+class flat_map {
+    static_assert(N > 0, "flat_map must have room for at least one entry");
+
+    utl::array<K,N> m_keys{};
+    utl::array<V,N> m_values{};
+    size_t m_size = 0;
+
+    //The first position whose key isn't less than key.
+    [[nodiscard]] constexpr size_t lower_index(K const& key) const
+    {
+        const K* first = m_keys.begin();
+        return static_cast<size_t>(utl::lower_bound(first, first + m_size, key) - first); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    [[nodiscard]] constexpr size_t index_of(K const& key) const
+    {
+        const size_t index = lower_index(key);
+        if(index < m_size and m_keys[index] == key) return index;
+        return npos;
+    }
+
+    //Requires that the map isn't full.
+    template <typename T>
+    constexpr V& insert_at(size_t index, K const& key, T&& value)
+    {
+        for(size_t idx = m_size; idx > index; idx--) {
+            m_keys[idx] = std::move(m_keys[idx - 1]);
+            m_values[idx] = std::move(m_values[idx - 1]);
+        }
+        m_keys[index] = key;
+        m_values[index] = std::forward<T>(value);
+        m_size++;
+        return m_values[index];
+    }
+
+    template <typename T>
+    class basic_iterator {
+        K const* m_key;
+        T* m_value;
+
+    public:
+        constexpr basic_iterator(K const* key, T* value) : m_key{key}, m_value{value} {}
+
+        constexpr auto operator*() const { return utl::tuple<K const&,T&>{*m_key, *m_value}; }
+
+        constexpr basic_iterator& operator++()
+        {
+            //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            m_key++;
+            m_value++;
+            //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            return *this;
+        }
+
+        constexpr basic_iterator operator++(int)
+        {
+            auto previous = *this;
+            operator++();
+            return previous;
+        }
+
+        constexpr bool operator==(basic_iterator const& other) const { return m_key == other.m_key; }
+    };
+
+public:
+    using key_t = K;
+    using value_t = V;
+    using iterator = basic_iterator<V>;
+    using const_iterator = basic_iterator<const V>;
+
+    struct entry {
+        K key;
+        V value;
+    };
+
+    constexpr flat_map() = default;
+
+    //Inserts the entries in order, so a repeated key is sorted in once
+    //and keeps the last value given for it. A constexpr map with more
+    //distinct keys than N doesn't compile; at runtime the keys that
+    //don't fit are dropped.
+    constexpr flat_map(std::initializer_list<entry> entries)
+    {
+        for(auto const& item : entries) {
+            const size_t index = lower_index(item.key);
+            if(index < m_size and m_keys[index] == item.key) {
+                m_values[index] = item.value;
+            } else if(not full()) {
+                insert_at(index, item.key, item.value);
+            } else if(std::is_constant_evaluated()) {
+                detail::fixed_map_too_many_entries();
+            }
+        }
+    }
+
+    static constexpr size_t capacity() { return N; }
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+    [[nodiscard]] constexpr bool full() const { return m_size == N; }
+
+    //The value for key, or nullptr if there isn't one.
+    [[nodiscard]] constexpr V* find(K const& key)
+    {
+        const size_t index = index_of(key);
+        return index == npos ? nullptr : &m_values[index];
+    }
+
+    [[nodiscard]] constexpr V const* find(K const& key) const
+    {
+        const size_t index = index_of(key);
+        return index == npos ? nullptr : &m_values[index];
+    }
+
+    [[nodiscard]] constexpr bool contains(K const& key) const
+    {
+        return index_of(key) != npos;
+    }
+
+    //Adds a new key at its sorted position, shifting the entries
+    //after it up one, and returns its value. A key that's already
+    //present keeps its value, which is returned instead. Returns
+    //errc::out_of_bounds if key is new and there's no room.
+    template <typename T = V>
+    constexpr result<V&> insert(K const& key, T&& value)
+    {
+        const size_t index = lower_index(key);
+        if(index < m_size and m_keys[index] == key) return success<V&>(m_values[index]);
+        if(full()) return errc::out_of_bounds;
+        return success<V&>(insert_at(index, key, std::forward<T>(value)));
+    }
+
+    //As insert, but a key that's already present has value assigned
+    //over its old one.
+    template <typename T = V>
+    constexpr result<V&> insert_or_assign(K const& key, T&& value)
+    {
+        const size_t index = lower_index(key);
+        if(index < m_size and m_keys[index] == key) {
+            m_values[index] = std::forward<T>(value);
+            return success<V&>(m_values[index]);
+        }
+        if(full()) return errc::out_of_bounds;
+        return success<V&>(insert_at(index, key, std::forward<T>(value)));
+    }
+
+    //Returns false if key wasn't in the map.
+    constexpr bool erase(K const& key)
+    {
+        const size_t index = index_of(key);
+        if(index == npos) return false;
+        for(size_t idx = index + 1; idx < m_size; idx++) {
+            m_keys[idx - 1] = std::move(m_keys[idx]);
+            m_values[idx - 1] = std::move(m_values[idx]);
+        }
+        m_size--;
+        m_keys[m_size] = K{};
+        m_values[m_size] = V{};
+        return true;
+    }
+
+    constexpr void clear()
+    {
+        for(size_t idx = 0; idx < m_size; idx++) {
+            m_keys[idx] = K{};
+            m_values[idx] = V{};
+        }
+        m_size = 0;
+    }
+
+    //The keys, in order, and the values in the same order.
+    [[nodiscard]] constexpr utl::span<const K> keys() const { return {m_keys.data(), m_size}; }
+    [[nodiscard]] constexpr utl::span<V> values() { return {m_values.data(), m_size}; }
+    [[nodiscard]] constexpr utl::span<const V> values() const { return {m_values.data(), m_size}; }
+
+    //Iterating gives a utl::tuple of the key and a reference to its
+    //value, in key order.
+    [[nodiscard]] constexpr iterator begin() { return {m_keys.begin(), m_values.begin()}; }
+    [[nodiscard]] constexpr const_iterator begin() const { return {m_keys.begin(), m_values.begin()}; }
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    [[nodiscard]] constexpr iterator end() { return {m_keys.begin() + m_size, m_values.begin() + m_size}; }
+    [[nodiscard]] constexpr const_iterator end() const { return {m_keys.begin() + m_size, m_values.begin() + m_size}; }
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+};
+
+} //namespace utl
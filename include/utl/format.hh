@@ -9,6 +9,7 @@
 
 #include <utl/string-view.hh>
 #include <utl/string.hh>
+#include <utl/static-string.hh>
 #include <utl/concepts.hh>
 #include <utl/result.hh>
 #include <utl/tuple.hh>
@@ -39,14 +40,17 @@ namespace utl {
 template <size_t N, fmt::formattable... Args>
 constexpr auto format(utl::string_view format, Args&&... args)
 {
-    array<char,N> buffer{};
-    format_into(buffer, format, std::forward<Args>(args)...);
-    return utl::string<N>{buffer.data()};
+    //formatted straight into the result; its terminator is past the
+    //end of the range format_into writes to
+    utl::string<N> result{};
+    format_into(result, format, std::forward<Args>(args)...);
+    return result;
 }
 
 template <fmt::formattable... Args>
 constexpr auto format_into(utl::ranges::output_iterable<char> auto&& buffer, utl::string_view format, 
     Args&&... args)
+    requires (not fmt::appendable<std::remove_reference_t<decltype(buffer)>>)
 {
     auto iter = utl::ranges::begin(buffer);
     auto end = utl::ranges::end(buffer);
@@ -78,6 +82,15 @@ constexpr void format_to(fmt::output& out, utl::string_view format, Args&&... ar
     fmt::vformat(out,format,arg_view);
 }
 
+//Appends to a container with push_back, such as a static_string,
+//without going through an intermediate buffer.
+template <fmt::formattable... Args>
+constexpr void format_into(fmt::appendable auto& container, utl::string_view format, Args&&... args)
+{
+    fmt::append_output_t out{container};
+    format_to(static_cast<fmt::output&>(out), format, std::forward<Args>(args)...);
+}
+
 
 namespace fmt {
 
@@ -0,0 +1,296 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <bit>
+#include <concepts>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/string-view.hh>
+
+namespace utl {
+
+//String hashes that give the same answer at compile time and at
+//runtime, so a table built by the compiler can be probed with a
+//string that arrives over the wire.
+
+constexpr uint32_t fnv1a32(string_view str)
+{
+    uint32_t hash = 0x811C'9DC5;
+    for(char c : str) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x0100'0193;
+    }
+    return hash;
+}
+
+constexpr uint64_t fnv1a64(string_view str)
+{
+    uint64_t hash = 0xCBF2'9CE4'8422'2325;
+    for(char c : str) {
+        hash = (hash ^ static_cast<uint8_t>(c)) * 0x0000'0100'0000'01B3;
+    }
+    return hash;
+}
+
+namespace detail::xxh32 {
+    inline constexpr uint32_t prime1 = 0x9E37'79B1;
+    inline constexpr uint32_t prime2 = 0x85EB'CA77;
+    inline constexpr uint32_t prime3 = 0xC2B2'AE3D;
+    inline constexpr uint32_t prime4 = 0x27D4'EB2F;
+    inline constexpr uint32_t prime5 = 0x1656'67B1;
+
+    //little endian, whatever the target; the compiler turns this into
+    //a single load where it can
+    constexpr uint32_t read32(const char* bytes)
+    {
+        //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        return static_cast<uint32_t>(static_cast<uint8_t>(bytes[0]))
+            | static_cast<uint32_t>(static_cast<uint8_t>(bytes[1])) << 8
+            | static_cast<uint32_t>(static_cast<uint8_t>(bytes[2])) << 16
+            | static_cast<uint32_t>(static_cast<uint8_t>(bytes[3])) << 24;
+        //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    constexpr uint32_t round(uint32_t accumulator, uint32_t input)
+    {
+        return std::rotl(accumulator + input * prime2, 13) * prime1;
+    }
+} //namespace detail::xxh32
+
+//xxHash32. Slower than FNV-1a on a handful of bytes, but it consumes
+//16 bytes per step and mixes far better, so prefer it for longer keys.
+constexpr uint32_t xxhash32(string_view str, uint32_t seed = 0)
+{
+    using namespace detail::xxh32;
+    const char* bytes = str.data();
+    const size_t length = str.size();
+    size_t pos = 0;
+    uint32_t hash{};
+
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    if(length >= 16) {
+        uint32_t v1 = seed + prime1 + prime2;
+        uint32_t v2 = seed + prime2;
+        uint32_t v3 = seed;
+        uint32_t v4 = seed - prime1;
+        for(; pos + 16 <= length; pos += 16) {
+            v1 = round(v1, read32(bytes + pos));
+            v2 = round(v2, read32(bytes + pos + 4));
+            v3 = round(v3, read32(bytes + pos + 8));
+            v4 = round(v4, read32(bytes + pos + 12));
+        }
+        hash = std::rotl(v1, 1) + std::rotl(v2, 7) + std::rotl(v3, 12) + std::rotl(v4, 18);
+    } else {
+        hash = seed + prime5;
+    }
+    hash += static_cast<uint32_t>(length);
+
+    for(; pos + 4 <= length; pos += 4) {
+        hash = std::rotl(hash + read32(bytes + pos) * prime3, 17) * prime4;
+    }
+    for(; pos < length; pos++) {
+        hash = std::rotl(hash + static_cast<uint8_t>(bytes[pos]) * prime5, 11) * prime1;
+    }
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    hash ^= hash >> 15;
+    hash *= prime2;
+    hash ^= hash >> 13;
+    hash *= prime3;
+    hash ^= hash >> 16;
+    return hash;
+}
+
+//The hash a key gets in a hash table, such as static_hash_map.
+//Specialize it for other key types.
+template <typename K>
+struct hash;
+
+//Integers are run through a finalizer (MurmurHash3's), so keys that
+//differ only in their high bits, or are all multiples of a stride,
+//still spread over the table's low bits.
+template <typename K>
+    requires std::integral<K> or std::is_enum_v<K>
+struct hash<K> {
+    constexpr size_t operator()(K key) const
+    {
+        if constexpr(sizeof(K) <= sizeof(uint32_t)) {
+            auto value = static_cast<uint32_t>(key);
+            value ^= value >> 16;
+            value *= 0x85EB'CA6B;
+            value ^= value >> 13;
+            value *= 0xC2B2'AE35;
+            value ^= value >> 16;
+            return value;
+        } else {
+            auto value = static_cast<uint64_t>(key);
+            value ^= value >> 33;
+            value *= 0xFF51'AFD7'ED55'8CCD;
+            value ^= value >> 33;
+            value *= 0xC4CE'B9FE'1A85'EC53;
+            value ^= value >> 33;
+            return static_cast<size_t>(value);
+        }
+    }
+};
+
+namespace detail {
+    //Deliberately not constexpr: reaching one of these while building a
+    //string_switch stops compilation, and the name says why.
+    void string_switch_duplicate_keyword();
+    void string_switch_no_perfect_hash();
+    void string_switch_unknown_keyword();
+} //namespace detail
+
+//Maps a fixed set of keywords to their positions in the list, via a
+//perfect hash table built at compile time: looking up a string costs
+//one FNV-1a pass over it, two table reads and one comparison, however
+//many keywords there are.
+//
+//    constexpr utl::string_switch commands{"help", "reset", "status"};
+//    switch(commands.find(input)) {
+//        case commands.index("help"): ...
+//        case commands.index("reset"): ...
+//        case utl::npos: //not a keyword
+//    }
+//
+//The table uses hash-and-displace: keywords are split into buckets by
+//their hash, and each bucket gets its own displacement, found at
+//compile time, that lands all of its keywords in free slots. There are
+//roughly two slots per keyword and one bucket per two keywords.
+template <size_t N>
+class string_switch {
+    static_assert(N > 0, "a string_switch needs at least one keyword");
+
+    using index_t = std::conditional_t<(N < 0xFF), uint8_t, uint16_t>;
+    static constexpr size_t n_slots = std::bit_ceil(2 * N);
+    static constexpr size_t slot_bits = static_cast<size_t>(std::countr_zero(n_slots));
+    static constexpr size_t n_buckets = std::bit_ceil((N + 1) / 2);
+
+    struct keyword {
+        const char* data;
+        size_t size;
+    };
+
+    utl::array<keyword,N> m_keywords{};
+    utl::array<index_t,n_slots> m_slots{}; //keyword index + 1; zero is empty
+    utl::array<uint16_t,n_buckets> m_displacements{};
+
+    static constexpr size_t bucket(uint32_t hash)
+    {
+        return hash & (n_buckets - 1);
+    }
+
+    static constexpr size_t place(uint32_t hash, uint16_t displacement)
+    {
+        const uint32_t mixed = (hash ^ (displacement * 0x9E37'79B9u)) * 0x85EB'CA6Bu;
+        return mixed >> (32 - slot_bits);
+    }
+
+    static constexpr bool equal(keyword const& kw, string_view str)
+    {
+        if(kw.size != str.size()) return false;
+        return string_view{kw.data, kw.size}.starts_with(str);
+    }
+
+    consteval void build()
+    {
+        utl::array<uint32_t,N> hashes{};
+        for(size_t idx = 0; idx < N; idx++) {
+            hashes[idx] = fnv1a32(keyword_at(idx));
+            for(size_t other = 0; other < idx; other++) {
+                if(equal(m_keywords[other], keyword_at(idx))) detail::string_switch_duplicate_keyword();
+            }
+        }
+
+        //place the fullest buckets first, while there's the most room
+        utl::array<size_t,n_buckets> sizes{};
+        for(auto hash : hashes) sizes[bucket(hash)]++;
+        utl::array<bool,n_buckets> placed{};
+        for(size_t round = 0; round < n_buckets; round++) {
+            size_t current = 0;
+            size_t largest = 0;
+            for(size_t idx = 0; idx < n_buckets; idx++) {
+                if(not placed[idx] and sizes[idx] >= largest) {
+                    current = idx;
+                    largest = sizes[idx];
+                }
+            }
+            placed[current] = true;
+            if(largest == 0) continue;
+            if(not place_bucket(current, hashes)) detail::string_switch_no_perfect_hash();
+        }
+    }
+
+    consteval bool place_bucket(size_t current, utl::array<uint32_t,N> const& hashes)
+    {
+        for(uint32_t displacement = 0; displacement <= 0xFFFF; displacement++) {
+            auto slots = m_slots;
+            bool fits = true;
+            for(size_t idx = 0; idx < N and fits; idx++) {
+                if(bucket(hashes[idx]) != current) continue;
+                auto& slot = slots[place(hashes[idx], static_cast<uint16_t>(displacement))];
+                if(slot != 0) fits = false;
+                slot = static_cast<index_t>(idx + 1);
+            }
+            if(fits) {
+                m_slots = slots;
+                m_displacements[current] = static_cast<uint16_t>(displacement);
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    template <std::convertible_to<string_view>... Ts>
+        requires (sizeof...(Ts) == N)
+    consteval string_switch(Ts const&... keywords)
+    {
+        size_t idx = 0;
+        ((m_keywords[idx++] = keyword{string_view{keywords}.data(), string_view{keywords}.size()}), ...);
+        build();
+    }
+
+    static constexpr size_t size() { return N; }
+
+    [[nodiscard]] constexpr string_view keyword_at(size_t idx) const
+    {
+        return {m_keywords[idx].data, m_keywords[idx].size};
+    }
+
+    //The position of str in the keyword list, or npos.
+    [[nodiscard]] constexpr size_t find(string_view str) const
+    {
+        const auto hash = fnv1a32(str);
+        const auto slot = m_slots[place(hash, m_displacements[bucket(hash)])];
+        if(slot == 0 or not equal(m_keywords[slot - 1], str)) return npos;
+        return slot - size_t{1};
+    }
+
+    [[nodiscard]] constexpr bool contains(string_view str) const
+    {
+        return find(str) != npos;
+    }
+
+    //find() for keywords known at compile time, for case labels; a
+    //string that isn't a keyword won't compile.
+    [[nodiscard]] consteval size_t index(string_view str) const
+    {
+        const auto found = find(str);
+        if(found == npos) detail::string_switch_unknown_keyword();
+        return found;
+    }
+};
+
+template <std::convertible_to<string_view>... Ts>
+string_switch(Ts const&...) -> string_switch<sizeof...(Ts)>;
+
+} //namespace utl
@@ -0,0 +1,249 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <bit>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/algorithm.hh>
+#include <utl/bits/intrusive_hook.hh>
+
+namespace utl {
+
+//The links for an intrusive_heap.
+class heap_hook {
+    heap_hook* m_parent = nullptr;
+    heap_hook* m_left = nullptr;
+    heap_hook* m_right = nullptr;
+
+    template <typename T, auto Key, typename C, auto Member>
+    friend class intrusive_heap;
+
+public:
+    constexpr heap_hook() = default;
+    constexpr heap_hook(heap_hook const&) {}
+    constexpr heap_hook& operator=(heap_hook const&) { return *this; } //NOLINT(bugprone-unhandled-self-assignment,cert-oop54-cpp)
+    constexpr ~heap_hook() = default;
+
+    [[nodiscard]] constexpr bool is_linked() const { return m_parent != nullptr; }
+};
+
+template <typename T>
+struct heap_mixin : T, heap_hook {};
+
+namespace detail::intrusive {
+    template <typename M>
+    struct member_of;
+
+    template <typename K, typename T>
+    struct member_of<K T::*> {
+        using type = K;
+    };
+} //namespace detail::intrusive
+
+//A priority queue whose links live in the elements, ordered by the
+//member Key: with the default comparison, top() is the element with
+//the smallest key, such as the timer that expires first.
+//
+//    struct timer : utl::heap_hook {
+//        uint32_t deadline;
+//    };
+//    utl::intrusive_heap<timer,&timer::deadline> timers{};
+//    timers.push(blink);
+//    ...
+//    while(not timers.empty() and timers.top().deadline <= now) {
+//        auto& expired = timers.top();
+//        timers.pop();
+//        ...
+//    }
+//
+//The hook is a base class or, given Member, a data member, as for
+//intrusive_list (heap_mixin adds it as a mixin). The heap is a
+//complete binary tree of the hooks themselves, so there's no array to
+//size and nothing is allocated; push, pop, erase, and re-keying an
+//element with update or decrease_key are all O(log n) in the worst
+//case, which is what rescheduling a pending timeout needs.
+//
+//An element can only be in one heap per hook, and must be removed
+//before it's destroyed. A heap refers to itself, so it can't be copied
+//or moved.
+template <typename T, auto Key, typename C = less, auto Member = nullptr>
+class intrusive_heap {
+    static_assert(std::is_member_object_pointer_v<decltype(Key)>, "an intrusive_heap's key must be a data member of its element");
+
+    using traits = detail::intrusive::hook_traits<T,heap_hook,Member>;
+
+    //The root is m_anchor's left child, so that every element has a
+    //parent and the root needs no special cases.
+    heap_hook m_anchor;
+    size_t m_size = 0;
+    [[no_unique_address]] C m_comp{};
+
+    [[nodiscard]] constexpr heap_hook* root() const { return m_anchor.m_left; }
+
+    [[nodiscard]] constexpr bool before(heap_hook const& a, heap_hook const& b) const
+    {
+        return m_comp(traits::to_element(a).*Key, traits::to_element(b).*Key);
+    }
+
+    //The hook at a position, counting from 1 in breadth first order:
+    //the bits of the position after its leading 1 are the path from
+    //the root, 0 for left and 1 for right.
+    [[nodiscard]] constexpr heap_hook* at(size_t position) const
+    {
+        heap_hook* hook = root();
+        for(auto bit = std::bit_floor(position) >> 1; bit != 0; bit >>= 1) {
+            hook = (position & bit) != 0 ? hook->m_right : hook->m_left;
+        }
+        return hook;
+    }
+
+    static constexpr void replace_child(heap_hook& parent, heap_hook const& child, heap_hook* replacement)
+    {
+        if(parent.m_left == &child) {
+            parent.m_left = replacement;
+        } else {
+            parent.m_right = replacement;
+        }
+    }
+
+    //Swaps hook with its parent, which can't be the anchor.
+    static constexpr void swap_with_parent(heap_hook& hook)
+    {
+        heap_hook& parent = *hook.m_parent;
+        heap_hook& grandparent = *parent.m_parent;
+        heap_hook* const left = hook.m_left;
+        heap_hook* const right = hook.m_right;
+
+        replace_child(grandparent, parent, &hook);
+        if(parent.m_left == &hook) {
+            hook.m_left = &parent;
+            hook.m_right = parent.m_right;
+            if(hook.m_right != nullptr) hook.m_right->m_parent = &hook;
+        } else {
+            hook.m_right = &parent;
+            hook.m_left = parent.m_left;
+            if(hook.m_left != nullptr) hook.m_left->m_parent = &hook;
+        }
+        hook.m_parent = &grandparent;
+
+        parent.m_left = left;
+        parent.m_right = right;
+        if(left != nullptr) left->m_parent = &parent;
+        if(right != nullptr) right->m_parent = &parent;
+        parent.m_parent = &hook;
+    }
+
+    constexpr void sift_up(heap_hook& hook)
+    {
+        while(hook.m_parent != &m_anchor and before(hook, *hook.m_parent)) swap_with_parent(hook);
+    }
+
+    constexpr void sift_down(heap_hook& hook)
+    {
+        while(true) {
+            heap_hook* child = hook.m_left;
+            if(child == nullptr) return;
+            if(hook.m_right != nullptr and before(*hook.m_right, *child)) child = hook.m_right;
+            if(not before(*child, hook)) return;
+            swap_with_parent(*child);
+        }
+    }
+
+    constexpr void restore(heap_hook& hook)
+    {
+        if(hook.m_parent != &m_anchor and before(hook, *hook.m_parent)) {
+            sift_up(hook);
+        } else {
+            sift_down(hook);
+        }
+    }
+
+    constexpr void remove(heap_hook& hook)
+    {
+        //the last hook fills the hole, then moves to where it belongs
+        heap_hook& last = *at(m_size);
+        replace_child(*last.m_parent, last, nullptr);
+        m_size--;
+        if(&last != &hook) {
+            last.m_parent = hook.m_parent;
+            last.m_left = hook.m_left;
+            last.m_right = hook.m_right;
+            replace_child(*last.m_parent, hook, &last);
+            if(last.m_left != nullptr) last.m_left->m_parent = &last;
+            if(last.m_right != nullptr) last.m_right->m_parent = &last;
+            restore(last);
+        }
+        hook.m_parent = nullptr;
+        hook.m_left = nullptr;
+        hook.m_right = nullptr;
+    }
+
+public:
+    using value_t = T;
+    using key_t = typename detail::intrusive::member_of<decltype(Key)>::type;
+
+    constexpr intrusive_heap() = default;
+    constexpr explicit intrusive_heap(C comp) : m_comp{comp} {}
+
+    intrusive_heap(intrusive_heap const&) = delete;
+    intrusive_heap& operator=(intrusive_heap const&) = delete;
+    intrusive_heap(intrusive_heap&&) = delete;
+    intrusive_heap& operator=(intrusive_heap&&) = delete;
+    constexpr ~intrusive_heap() = default;
+
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+
+    //Requires that the heap isn't empty.
+    [[nodiscard]] constexpr T& top() { return traits::to_element(*root()); }
+    [[nodiscard]] constexpr T const& top() const { return traits::to_element(*root()); }
+
+    //Requires that the element isn't in a heap.
+    constexpr void push(T& element)
+    {
+        heap_hook& hook = traits::to_hook(element);
+        m_size++;
+        heap_hook* parent = m_size == 1 ? &m_anchor : at(m_size / 2);
+        if(m_size == 1 or m_size % 2 == 0) {
+            parent->m_left = &hook;
+        } else {
+            parent->m_right = &hook;
+        }
+        hook.m_parent = parent;
+        hook.m_left = nullptr;
+        hook.m_right = nullptr;
+        sift_up(hook);
+    }
+
+    //Requires that the heap isn't empty.
+    constexpr void pop() { remove(*root()); }
+
+    //Removes an element that's in this heap, such as a timer that's
+    //been cancelled.
+    constexpr void erase(T& element) { remove(traits::to_hook(element)); }
+
+    //Restores the order after an element's key has changed, in either
+    //direction.
+    constexpr void update(T& element) { restore(traits::to_hook(element)); }
+
+    //Gives an element a key that comes no later than its current one,
+    //such as an earlier deadline.
+    constexpr void decrease_key(T& element, key_t key)
+    {
+        element.*Key = key;
+        sift_up(traits::to_hook(element));
+    }
+
+    constexpr void clear()
+    {
+        while(not empty()) pop();
+    }
+};
+
+} //namespace utl
@@ -0,0 +1,345 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utl/utl.hh>
+#include <utl/bits/intrusive_hook.hh>
+
+namespace utl {
+
+//Linked lists whose links live in the elements, for objects that are
+//owned elsewhere (by a driver, or statically) and only need to be put
+//in order: pending requests, wait queues, timers. Nothing is copied
+//and nothing is allocated; adding and removing are a few pointer
+//writes.
+//
+//An element carries a hook for each list it can be in, either as a
+//base class:
+//
+//    struct request : utl::list_hook { ... };
+//    utl::intrusive_list<request> pending{};
+//
+//or as a member, which allows one per list:
+//
+//    struct request {
+//        utl::list_hook pending_link;
+//        utl::slist_hook free_link;
+//    };
+//    utl::intrusive_list<request,&request::pending_link> pending{};
+//    utl::intrusive_slist<request,&request::free_link> free{};
+//
+//For types composed with utl::mix, list_mixin and slist_mixin add the
+//hook as a mixin.
+//
+//An element can only be in one list per hook, and must be removed
+//before it's destroyed. Copying an element doesn't copy its links.
+//Lists refer to themselves, so they can't be copied or moved.
+
+//The links for an intrusive_list.
+class list_hook {
+    list_hook* m_next = nullptr;
+    list_hook* m_prev = nullptr;
+
+    template <typename T, auto Member>
+    friend class intrusive_list;
+
+public:
+    constexpr list_hook() = default;
+    constexpr list_hook(list_hook const&) {}
+    constexpr list_hook& operator=(list_hook const&) { return *this; } //NOLINT(bugprone-unhandled-self-assignment,cert-oop54-cpp)
+    constexpr ~list_hook() = default;
+
+    [[nodiscard]] constexpr bool is_linked() const { return m_next != nullptr; }
+};
+
+//The link for an intrusive_slist.
+class slist_hook {
+    slist_hook* m_next = nullptr;
+
+    template <typename T, auto Member>
+    friend class intrusive_slist;
+
+public:
+    constexpr slist_hook() = default;
+    constexpr slist_hook(slist_hook const&) {}
+    constexpr slist_hook& operator=(slist_hook const&) { return *this; } //NOLINT(bugprone-unhandled-self-assignment,cert-oop54-cpp)
+    constexpr ~slist_hook() = default;
+
+    [[nodiscard]] constexpr bool is_linked() const { return m_next != nullptr; }
+};
+
+template <typename T>
+struct list_mixin : T, list_hook {};
+
+template <typename T>
+struct slist_mixin : T, slist_hook {};
+
+//A doubly linked list: O(1) insertion and removal anywhere, given the
+//element. It's circular through a hook in the list itself, so there
+//are no special cases at the ends.
+template <typename T, auto Member = nullptr>
+class intrusive_list {
+    using traits = detail::intrusive::hook_traits<T,list_hook,Member>;
+
+    list_hook m_head;
+    size_t m_size = 0;
+
+    static constexpr void link_before(list_hook& next, list_hook& hook)
+    {
+        hook.m_next = &next;
+        hook.m_prev = next.m_prev;
+        next.m_prev->m_next = &hook;
+        next.m_prev = &hook;
+    }
+
+    static constexpr void unlink(list_hook& hook)
+    {
+        hook.m_prev->m_next = hook.m_next;
+        hook.m_next->m_prev = hook.m_prev;
+        hook.m_next = nullptr;
+        hook.m_prev = nullptr;
+    }
+
+    template <typename E, typename H>
+    class basic_iterator {
+        H* m_hook;
+
+        friend class intrusive_list;
+
+    public:
+        constexpr explicit basic_iterator(H* hook) : m_hook{hook} {}
+
+        constexpr E& operator*() const { return traits::to_element(*m_hook); }
+        constexpr E* operator->() const { return &traits::to_element(*m_hook); }
+
+        constexpr basic_iterator& operator++()
+        {
+            m_hook = m_hook->m_next;
+            return *this;
+        }
+
+        constexpr basic_iterator operator++(int)
+        {
+            auto previous = *this;
+            operator++();
+            return previous;
+        }
+
+        constexpr basic_iterator& operator--()
+        {
+            m_hook = m_hook->m_prev;
+            return *this;
+        }
+
+        constexpr basic_iterator operator--(int)
+        {
+            auto previous = *this;
+            operator--();
+            return previous;
+        }
+
+        constexpr bool operator==(basic_iterator const& other) const { return m_hook == other.m_hook; }
+    };
+
+public:
+    using value_t = T;
+    using iterator = basic_iterator<T,list_hook>;
+    using const_iterator = basic_iterator<const T,const list_hook>;
+
+    constexpr intrusive_list()
+    {
+        m_head.m_next = &m_head;
+        m_head.m_prev = &m_head;
+    }
+
+    intrusive_list(intrusive_list const&) = delete;
+    intrusive_list& operator=(intrusive_list const&) = delete;
+    intrusive_list(intrusive_list&&) = delete;
+    intrusive_list& operator=(intrusive_list&&) = delete;
+    constexpr ~intrusive_list() = default;
+
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+
+    //These require that the list isn't empty.
+    [[nodiscard]] constexpr T& front() { return traits::to_element(*m_head.m_next); }
+    [[nodiscard]] constexpr T const& front() const { return traits::to_element(*m_head.m_next); }
+    [[nodiscard]] constexpr T& back() { return traits::to_element(*m_head.m_prev); }
+    [[nodiscard]] constexpr T const& back() const { return traits::to_element(*m_head.m_prev); }
+
+    [[nodiscard]] constexpr iterator begin() { return iterator{m_head.m_next}; }
+    [[nodiscard]] constexpr const_iterator begin() const { return const_iterator{m_head.m_next}; }
+    [[nodiscard]] constexpr iterator end() { return iterator{&m_head}; }
+    [[nodiscard]] constexpr const_iterator end() const { return const_iterator{&m_head}; }
+
+    //The position of an element that's in this list.
+    [[nodiscard]] constexpr iterator iterator_to(T& element) { return iterator{&traits::to_hook(element)}; }
+
+    //These require that the element isn't in a list.
+    constexpr void push_front(T& element) { insert(begin(), element); }
+    constexpr void push_back(T& element) { insert(end(), element); }
+
+    //Inserts element before pos, and returns its position.
+    constexpr iterator insert(iterator pos, T& element)
+    {
+        auto& hook = traits::to_hook(element);
+        link_before(*pos.m_hook, hook);
+        m_size++;
+        return iterator{&hook};
+    }
+
+    //These require that the list isn't empty.
+    constexpr void pop_front() { erase(front()); }
+    constexpr void pop_back() { erase(back()); }
+
+    //Removes an element that's in this list.
+    constexpr void erase(T& element)
+    {
+        unlink(traits::to_hook(element));
+        m_size--;
+    }
+
+    //Removes the element at pos, and returns the position after it.
+    constexpr iterator erase(iterator pos)
+    {
+        iterator next{pos.m_hook->m_next};
+        erase(*pos);
+        return next;
+    }
+
+    constexpr void clear()
+    {
+        while(not empty()) pop_front();
+    }
+};
+
+//A singly linked list, with a hook half the size of list_hook's.
+//Adding at either end and removing from the front are O(1), which is
+//all a FIFO or a free list needs; removing anything else means finding
+//the element before it. It's circular through a hook in the list
+//itself, as intrusive_list is.
+template <typename T, auto Member = nullptr>
+class intrusive_slist {
+    using traits = detail::intrusive::hook_traits<T,slist_hook,Member>;
+
+    slist_hook m_head;
+    slist_hook* m_tail;
+    size_t m_size = 0;
+
+    template <typename E, typename H>
+    class basic_iterator {
+        H* m_hook;
+
+        friend class intrusive_slist;
+
+    public:
+        constexpr explicit basic_iterator(H* hook) : m_hook{hook} {}
+
+        constexpr E& operator*() const { return traits::to_element(*m_hook); }
+        constexpr E* operator->() const { return &traits::to_element(*m_hook); }
+
+        constexpr basic_iterator& operator++()
+        {
+            m_hook = m_hook->m_next;
+            return *this;
+        }
+
+        constexpr basic_iterator operator++(int)
+        {
+            auto previous = *this;
+            operator++();
+            return previous;
+        }
+
+        constexpr bool operator==(basic_iterator const& other) const { return m_hook == other.m_hook; }
+    };
+
+public:
+    using value_t = T;
+    using iterator = basic_iterator<T,slist_hook>;
+    using const_iterator = basic_iterator<const T,const slist_hook>;
+
+    constexpr intrusive_slist() : m_tail{&m_head}
+    {
+        m_head.m_next = &m_head;
+    }
+
+    intrusive_slist(intrusive_slist const&) = delete;
+    intrusive_slist& operator=(intrusive_slist const&) = delete;
+    intrusive_slist(intrusive_slist&&) = delete;
+    intrusive_slist& operator=(intrusive_slist&&) = delete;
+    constexpr ~intrusive_slist() = default;
+
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+
+    //These require that the list isn't empty.
+    [[nodiscard]] constexpr T& front() { return traits::to_element(*m_head.m_next); }
+    [[nodiscard]] constexpr T const& front() const { return traits::to_element(*m_head.m_next); }
+    [[nodiscard]] constexpr T& back() { return traits::to_element(*m_tail); }
+    [[nodiscard]] constexpr T const& back() const { return traits::to_element(*m_tail); }
+
+    //before_begin() is the position before the first element, for
+    //insert_after and erase_after.
+    [[nodiscard]] constexpr iterator before_begin() { return iterator{&m_head}; }
+    [[nodiscard]] constexpr iterator begin() { return iterator{m_head.m_next}; }
+    [[nodiscard]] constexpr const_iterator begin() const { return const_iterator{m_head.m_next}; }
+    [[nodiscard]] constexpr iterator end() { return iterator{&m_head}; }
+    [[nodiscard]] constexpr const_iterator end() const { return const_iterator{&m_head}; }
+
+    //These require that the element isn't in a list.
+    constexpr void push_front(T& element) { insert_after(before_begin(), element); }
+    constexpr void push_back(T& element) { insert_after(iterator{m_tail}, element); }
+
+    //Inserts element after pos, and returns its position.
+    constexpr iterator insert_after(iterator pos, T& element)
+    {
+        auto& hook = traits::to_hook(element);
+        hook.m_next = pos.m_hook->m_next;
+        pos.m_hook->m_next = &hook;
+        if(pos.m_hook == m_tail) m_tail = &hook;
+        m_size++;
+        return iterator{&hook};
+    }
+
+    //Requires that the list isn't empty.
+    constexpr void pop_front() { erase_after(before_begin()); }
+
+    //Removes the element after pos, which requires that there is one,
+    //and returns the position after the removed element.
+    constexpr iterator erase_after(iterator pos)
+    {
+        slist_hook* hook = pos.m_hook->m_next;
+        pos.m_hook->m_next = hook->m_next;
+        if(hook == m_tail) m_tail = pos.m_hook;
+        hook->m_next = nullptr;
+        m_size--;
+        return iterator{pos.m_hook->m_next};
+    }
+
+    //Removes element, searching the list for it. Returns false if it
+    //isn't in this list.
+    constexpr bool remove(T& element)
+    {
+        const slist_hook* target = &traits::to_hook(element);
+        for(auto pos = before_begin(); pos.m_hook->m_next != &m_head; ++pos) {
+            if(pos.m_hook->m_next == target) {
+                erase_after(pos);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    constexpr void clear()
+    {
+        while(not empty()) pop_front();
+    }
+};
+
+} //namespace utl
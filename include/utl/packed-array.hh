@@ -0,0 +1,204 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <bit>
+#include <type_traits>
+#include <utility>
+#include <utl/utl.hh>
+#include <utl/integer.hh>
+#include <utl/array.hh>
+#include <utl/span.hh>
+
+namespace utl {
+
+//N unsigned values of W bits each, stored back to back in machine
+//words with no padding: 100 12-bit ADC samples take 150 bytes rather
+//than 200. Element I occupies bits [I*W, I*W + W) of the storage,
+//counting from the least significant bit of the first word.
+//
+//One word beyond the last is kept zeroed, so reading an element that
+//straddles two words never needs a branch. unpack() works through
+//the storage in blocks whose layout repeats (16 elements in three
+//words, for 12-bit elements), which the compiler can unroll and
+//vectorize.
+template <utl::integer::convertible_to_unsigned T, size_t N>
+class packed_array {
+public:
+    using value_t = std::remove_cv_t<T>;
+    static constexpr size_t element_width = utl::integer::width<value_t>();
+
+private:
+    //use native words unless an element can't fit in one
+    using word_t = std::conditional_t<(element_width <= sizeof(uintptr_t) * 8), uintptr_t, uint64_t>;
+    static constexpr size_t word_width = sizeof(word_t) * 8;
+    static constexpr size_t n_words = (N * element_width + word_width - 1) / word_width;
+    static constexpr word_t mask = element_width == word_width ? ~word_t{0} : (word_t{1} << element_width) - 1;
+
+    static_assert(element_width > 0 and element_width <= 64, "elements must be between 1 and 64 bits wide");
+
+    utl::array<word_t,n_words + 1> m_words{};
+
+    [[nodiscard]] constexpr word_t load(size_t index) const
+    {
+        const auto bit = index * element_width;
+        const auto word = bit / word_width;
+        const auto shift = bit % word_width;
+        //shifting in two steps keeps the shift below the word width
+        //when the element doesn't straddle
+        const auto low = m_words[word] >> shift;
+        const auto high = (m_words[word + 1] << 1) << (word_width - 1 - shift);
+        return (low | high) & mask;
+    }
+
+    //Element positions repeat every block_words words, which hold
+    //block_elements elements; within a block every position is a
+    //constant, so a block unpacks with fixed shifts and no branches.
+    //word_width is a power of two, so the gcd of the two widths is the
+    //lowest bit set in either.
+    static constexpr size_t common_width = size_t{1} << std::countr_zero(element_width | word_width);
+    static constexpr size_t block_elements = word_width / common_width;
+    static constexpr size_t block_words = element_width / common_width;
+
+    template <size_t J>
+    static constexpr value_t extract(word_t const* words)
+    {
+        constexpr size_t bit = J * element_width;
+        constexpr size_t word = bit / word_width;
+        constexpr size_t shift = bit % word_width;
+        //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if constexpr(shift + element_width <= word_width) {
+            return static_cast<value_t>((words[word] >> shift) & mask);
+        } else {
+            return static_cast<value_t>(((words[word] >> shift) | (words[word + 1] << (word_width - shift))) & mask);
+        }
+        //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    constexpr void store(size_t index, word_t value)
+    {
+        const auto bit = index * element_width;
+        const auto word = bit / word_width;
+        const auto shift = bit % word_width;
+        value &= mask;
+        m_words[word] = (m_words[word] & ~(mask << shift)) | (value << shift);
+        if(shift + element_width > word_width) {
+            const auto spill = word_width - shift;
+            m_words[word + 1] = (m_words[word + 1] & ~(mask >> spill)) | (value >> spill);
+        }
+    }
+
+public:
+    //A reference to one element.
+    class reference {
+        packed_array& m_array;
+        size_t m_index;
+
+    public:
+        constexpr reference(packed_array& array, size_t index) : m_array{array}, m_index{index} {}
+        constexpr reference(reference const&) = default;
+        constexpr reference(reference&&) noexcept = default;
+        ~reference() = default;
+
+        constexpr operator value_t() const { return m_array.get(m_index); } //NOLINT(google-explicit-constructor)
+
+        constexpr reference& operator=(value_t value)
+        {
+            m_array.set(m_index, value);
+            return *this;
+        }
+
+        constexpr reference& operator=(reference const& other)
+        {
+            return operator=(static_cast<value_t>(other));
+        }
+
+        constexpr reference& operator=(reference&& other) noexcept
+        {
+            return operator=(static_cast<value_t>(other));
+        }
+    };
+
+    constexpr packed_array() = default;
+
+    static constexpr size_t size() { return N; }
+
+    //Bytes of storage used, not counting the trailing word.
+    static constexpr size_t storage_size() { return n_words * sizeof(word_t); }
+
+    [[nodiscard]] constexpr value_t get(size_t index) const
+    {
+        return static_cast<value_t>(load(index));
+    }
+
+    constexpr void set(size_t index, value_t value)
+    {
+        store(index, static_cast<word_t>(value));
+    }
+
+    constexpr reference operator[](size_t index) { return {*this, index}; }
+    constexpr value_t operator[](size_t index) const { return get(index); }
+
+    //Sets every element to value. One block's worth of words is
+    //built, then copied over the storage a word at a time.
+    constexpr void fill(value_t value)
+    {
+        packed_array<T,block_elements> pattern{};
+        for(size_t idx = 0; idx < block_elements; idx++) pattern.set(idx, value);
+        for(size_t idx = 0; idx < n_words; idx++) {
+            m_words[idx] = pattern.m_words[idx % block_words];
+        }
+        //keep the bits past the last element clear
+        constexpr size_t tail = (N * element_width) % word_width;
+        if constexpr(tail != 0) {
+            m_words[n_words - 1] &= (word_t{1} << tail) - 1;
+        }
+    }
+
+    //Copies every element out into an ordinary array, a block at a
+    //time.
+    constexpr void unpack(utl::span<value_t> out) const
+    {
+        const auto count = out.size() < N ? out.size() : N;
+        const auto n_blocks = count / block_elements;
+        for(size_t block = 0; block < n_blocks; block++) {
+            word_t const* words = m_words.data() + block * block_words; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            value_t* values = out.data() + block * block_elements; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            [&]<size_t... Js>(std::index_sequence<Js...>) {
+                ((values[Js] = extract<Js>(words)), ...); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }(std::make_index_sequence<block_elements>{});
+        }
+        for(size_t idx = n_blocks * block_elements; idx < count; idx++) {
+            out[idx] = static_cast<value_t>(load(idx));
+        }
+    }
+
+    [[nodiscard]] constexpr utl::array<value_t,N> unpack() const
+    {
+        utl::array<value_t,N> out{};
+        unpack(out);
+        return out;
+    }
+
+    //Sets elements from an ordinary array, starting at the first.
+    constexpr void pack(utl::span<const value_t> in)
+    {
+        const auto count = in.size() < N ? in.size() : N;
+        for(size_t idx = 0; idx < count; idx++) {
+            store(idx, static_cast<word_t>(in[idx]));
+        }
+    }
+
+    [[nodiscard]] constexpr utl::span<const word_t> words() const { return {m_words.data(), n_words}; }
+
+    template <utl::integer::convertible_to_unsigned, size_t>
+    friend class packed_array;
+};
+
+} //namespace utl
@@ -2,7 +2,9 @@
 
 #include <utility>
 #include <utl/bitfield.hh>
-#include <utl/hof/fold.hh>
+#include <utl/array.hh>
+#include <utl/type-list.hh>
+#include <utl/tuple.hh>
 #include <utl/hof/compose.hh>
 
 namespace utl::pal {
@@ -39,45 +41,41 @@ concept any_peripheral = requires(T v) {
 };
 
 
-//get a field using its tag value
-template <utl::any_enum auto V>
-constexpr auto get_field(any_peripheral auto& p)
-{
-	// template <auto V>
-	constexpr auto find_accumulate = [](auto&& accum, auto& item) {
-		using item_t = std::decay_t<decltype(item)>; //bitstruct (register)
-
-		if constexpr(utl::has_field<item_t,V>) {
-			return get_field<V>(item);
-		} else {
-			return accum;
-		}
+namespace detail {
+	template <typename E, typename T>
+	struct register_index;
+
+	//each register's fields are tagged with their own enum type, so
+	//a tag type identifies a register.
+	template <typename E, typename... Rs>
+	struct register_index<E,utl::tuple<Rs...>> {
+		static constexpr size_t value = utl::find_type_index_v<E,typename std::decay_t<Rs>::tag_t...>;
+		static constexpr bool found = value < sizeof...(Rs);
 	};
 
-	return utl::hof::foldl(p.registers(), nullptr, find_accumulate);
-}
-
-// template <utl::any_enum auto V, any_peripheral T>
-// using field_t = std::remove_reference_t<decltype(get_field<V>(std::declval<T>()))>;
+	template <typename E, any_peripheral P>
+	using register_index_t = register_index<E,std::decay_t<decltype(std::declval<P&>().registers())>>;
+} //namespace detail
 
 //get a register using its tag type
 template <utl::any_enum E>
 constexpr auto& get_register(any_peripheral auto& p)
 {
-	// template <auto V>
-	constexpr auto find_accumulate = [](auto&& accum, auto& item) -> decltype(auto) {
-		using item_t = std::decay_t<decltype(item)>; //bitstruct (register)
-
-		if constexpr(std::same_as<E,typename item_t::tag_t>) {
-			return item;
-		} else {
-			return accum;
-		}
-	};
+	using index_t = detail::register_index_t<E,std::decay_t<decltype(p)>>;
+	static_assert(index_t::found, "peripheral has no register with this tag type");
+	return get<index_t::value>(p.registers());
+}
 
-	return utl::hof::foldl(p.registers(), nullptr, find_accumulate);
+//get a field using its tag value
+template <utl::any_enum auto V>
+constexpr auto get_field(any_peripheral auto& p)
+{
+	return get_field<V>(get_register<std::decay_t<decltype(V)>>(p));
 }
 
+// template <utl::any_enum auto V, any_peripheral T>
+// using field_t = std::remove_reference_t<decltype(get_field<V>(std::declval<T>()))>;
+
 namespace op {
     template <utl::any_enum auto V, typename T>
     struct assign {
@@ -134,4 +132,219 @@ constexpr auto write(P& p, T&& head, Ts&&... ops)
     return value; //return the new register value
 }
 
+//Policies for the order in which apply() writes registers. Each gives
+//a register (by tag type) a rank; registers are written in ascending
+//rank, and ties keep the order of the first op on each register.
+namespace order {
+	//in the order each register is first mentioned
+	struct first_use {
+		template <any_peripheral P, utl::any_enum E>
+		static constexpr size_t rank() { return 0; }
+	};
+
+	//in the order the peripheral's registers() lists them
+	struct declaration {
+		template <any_peripheral P, utl::any_enum E>
+		static constexpr size_t rank() { return detail::register_index_t<E,P>::value; }
+	};
+
+	//the listed registers first, in the order given, then the rest
+	//in first-use order
+	template <utl::any_enum... Es>
+	struct tags {
+		template <any_peripheral P, utl::any_enum E>
+		static constexpr size_t rank() { return utl::find_type_index_v<E,Es...>; }
+	};
+} //namespace order
+
+namespace detail {
+	template <typename P>
+	struct apply_order {
+		using type = order::first_use;
+	};
+
+	template <typename P>
+		requires requires { typename P::apply_order_t; }
+	struct apply_order<P> {
+		using type = typename P::apply_order_t;
+	};
+
+	template <size_t N>
+	struct apply_schedule {
+		utl::array<size_t,N> leaders{};
+		size_t n_registers = 0;
+	};
+
+	//Finds the first op on each register and sorts those by the order
+	//policy's rank. E are the tag types of each op, in argument order.
+	template <typename Order, typename P, typename... Es>
+	consteval auto make_apply_schedule()
+	{
+		constexpr size_t n_ops = sizeof...(Es);
+		constexpr utl::array<size_t,n_ops> first{{utl::find_type_index_v<Es,Es...>...}};
+		constexpr utl::array<size_t,n_ops> rank{{Order::template rank<P,Es>()...}};
+
+		apply_schedule<n_ops> schedule{};
+		for(size_t idx = 0; idx < n_ops; idx++) {
+			if(first[idx] == idx) schedule.leaders[schedule.n_registers++] = idx;
+		}
+		//insertion sort, so ties stay in first-use order
+		for(size_t idx = 1; idx < schedule.n_registers; idx++) {
+			for(size_t jdx = idx; jdx > 0 and rank[schedule.leaders[jdx - 1]] > rank[schedule.leaders[jdx]]; jdx--) {
+				const auto leader = schedule.leaders[jdx];
+				schedule.leaders[jdx] = schedule.leaders[jdx - 1];
+				schedule.leaders[jdx - 1] = leader;
+			}
+		}
+		return schedule;
+	}
+
+	//Applies every op on the register the op at Leader targets to a
+	//single copy of it, then writes that back.
+	template <size_t Leader, typename... Ts>
+	constexpr auto write_register(any_peripheral auto& p, utl::tuple<Ts...> const& ops)
+	{
+		using tag_t = op::field_tag_t<utl::get_t<Leader,Ts...>>;
+		auto value = read<tag_t>(p);
+		[&]<size_t... Is>(std::index_sequence<Is...>) {
+			([&] {
+				if constexpr(std::same_as<op::field_tag_t<Ts>,tag_t>) {
+					value = get<Is>(ops)(std::move(value));
+				}
+			}(), ...);
+		}(std::index_sequence_for<Ts...>{});
+		get_register<tag_t>(p) = value;
+		return value;
+	}
+} //namespace detail
+
+//Applies ops to fields of any of a peripheral's registers. Each
+//register they touch is read once and written once, in the order
+//given by Order; by default that's the peripheral's apply_order_t
+//if it has one, or first use. Returns the value written to each
+//register, in the order they were written.
+template <typename Order, any_peripheral P, typename... Ts>
+constexpr auto apply(P& p, Ts&&... ops)
+	requires (sizeof...(Ts) > 0)
+{
+	constexpr auto schedule = detail::make_apply_schedule<Order,P,op::field_tag_t<Ts>...>();
+	const utl::tuple<std::decay_t<Ts>...> all{std::forward<Ts>(ops)...};
+
+	return [&]<size_t... Is>(std::index_sequence<Is...>) {
+		//a braced list, so registers are written left to right
+		return utl::tuple{detail::write_register<schedule.leaders[Is]>(p, all)...};
+	}(std::make_index_sequence<schedule.n_registers>{});
+}
+
+template <any_peripheral P, typename... Ts>
+constexpr auto apply(P& p, Ts&&... ops)
+	requires (sizeof...(Ts) > 0)
+{
+	return apply<typename detail::apply_order<P>::type>(p, std::forward<Ts>(ops)...);
+}
+
+namespace detail {
+	template <typename R>
+	concept has_reset_value = requires {
+		{ std::decay_t<R>::reset_value() } -> std::convertible_to<typename std::decay_t<R>::value_t>;
+	};
+
+	template <typename T>
+	struct snapshot_layout;
+
+	//Each register is stored in the fewest whole bytes that hold it,
+	//with no padding between registers.
+	template <typename... Rs>
+	struct snapshot_layout<utl::tuple<Rs...>> {
+		static constexpr size_t n_registers = sizeof...(Rs);
+		static constexpr utl::array<size_t,n_registers> sizes{{(std::decay_t<Rs>::width() + 7) / 8 ...}};
+		static constexpr utl::array<size_t,n_registers> offsets = []() {
+			utl::array<size_t,n_registers> result{};
+			size_t offset = 0;
+			for(size_t idx = 0; idx < n_registers; idx++) {
+				result[idx] = offset;
+				offset += sizes[idx];
+			}
+			return result;
+		}();
+		static constexpr size_t size = (0 + ... + ((std::decay_t<Rs>::width() + 7) / 8));
+	};
+
+	template <any_peripheral P>
+	using registers_t = std::decay_t<decltype(std::declval<P&>().registers())>;
+} //namespace detail
+
+//A peripheral's register contents, packed into as few bytes as
+//possible (e.g. for retention RAM during deep sleep).
+template <any_peripheral P>
+class snapshot_t {
+	using registers_t = detail::registers_t<P>;
+	using layout_t = detail::snapshot_layout<registers_t>;
+
+	template <size_t I>
+	using register_t = std::decay_t<utl::tuple_element_t<I,registers_t>>;
+
+	utl::array<uint8_t,layout_t::size> m_bytes{};
+
+public:
+	static constexpr size_t n_registers() { return layout_t::n_registers; }
+	static constexpr size_t size() { return layout_t::size; }
+
+	template <size_t I>
+	[[nodiscard]] constexpr auto get() const
+	{
+		using value_t = typename register_t<I>::value_t;
+		value_t value{0};
+		for(size_t idx = 0; idx < layout_t::sizes[I]; idx++) {
+			value = static_cast<value_t>(value | static_cast<value_t>(
+				static_cast<value_t>(m_bytes[layout_t::offsets[I] + idx]) << (8 * idx)));
+		}
+		return value;
+	}
+
+	template <size_t I>
+	constexpr void set(typename register_t<I>::value_t value)
+	{
+		for(size_t idx = 0; idx < layout_t::sizes[I]; idx++) {
+			m_bytes[layout_t::offsets[I] + idx] = static_cast<uint8_t>(value >> (8 * idx));
+		}
+	}
+};
+
+//Reads every register of a peripheral once.
+template <any_peripheral P>
+constexpr auto snapshot(P& p)
+{
+	snapshot_t<P> result{};
+	auto registers = p.registers();
+	[&]<size_t... Is>(std::index_sequence<Is...>) {
+		(result.template set<Is>(std::decay_t<decltype(get<Is>(registers))>{get<Is>(registers)}.value), ...);
+	}(std::make_index_sequence<snapshot_t<P>::n_registers()>{});
+	return result;
+}
+
+//Writes a snapshot back, in registers() order. Meant for a peripheral
+//that has just come out of reset, so registers that declare a
+//reset_value() and still hold it are skipped. Returns the number of
+//registers written.
+template <any_peripheral P>
+constexpr size_t restore(P& p, snapshot_t<P> const& saved)
+{
+	size_t written = 0;
+	auto registers = p.registers();
+	[&]<size_t... Is>(std::index_sequence<Is...>) {
+		([&] {
+			using register_t = std::decay_t<decltype(get<Is>(registers))>;
+			register_t value{};
+			value.value = saved.template get<Is>();
+			if constexpr(detail::has_reset_value<register_t>) {
+				if(value.value == register_t::reset_value()) return;
+			}
+			get<Is>(registers) = value;
+			written++;
+		}(), ...);
+	}(std::make_index_sequence<snapshot_t<P>::n_registers()>{});
+	return written;
+}
+
 } //namespace utl::pal
@@ -31,16 +31,16 @@ namespace utl::ranges {
 
 
 template <typename T>
-constexpr auto* begin(T&& container) { return container.begin(); }
+constexpr auto begin(T&& container) -> decltype(container.begin()) { return container.begin(); }
 
 template <typename T, size_t N>
 constexpr auto* begin(T (&container)[N]) { return &container[0]; } //NOLINT(cppcoreguidelines-avoid-c-arrays)
 
 template <typename T>
-constexpr auto* end(T&& container) { return container.end(); }
+constexpr auto end(T&& container) -> decltype(container.end()) { return container.end(); }
 
 template <typename T, size_t N>
-constexpr auto* end(T (&container)[N]) { return &container[N-1]; } //NOLINT(cppcoreguidelines-avoid-c-arrays)
+constexpr auto* end(T (&container)[N]) { return &container[0] + N; } //NOLINT(cppcoreguidelines-avoid-c-arrays,cppcoreguidelines-pro-bounds-pointer-arithmetic)
 
 //FIXME: these concepts need a lot of refinement.
 
@@ -71,19 +71,26 @@ struct range_traits {
 template <iterable T>
 constexpr auto enumerate(T&& container)
 {
+    //a temporary container is moved in, so that it lives as long as
+    //the enumerator does; anything else is referred to
+    using container_t = std::conditional_t<std::is_lvalue_reference_v<T>,T,std::remove_cvref_t<T>>;
+    using container_begin_t = decltype(utl::ranges::begin(std::declval<container_t const&>()));
+    using container_end_t = decltype(utl::ranges::end(std::declval<container_t const&>()));
     struct iterator {
-        using container_begin_t = typename range_traits<T>::begin_t;
         size_t index;
         container_begin_t iter;
 
-        constexpr void operator ++() { iter++; index++; }
-        constexpr bool operator !=(iterator const& other) const { return iter != other.iter; }
-        constexpr auto operator *() const { return utl::tie(index, *iter); }
+        constexpr iterator& operator ++() { ++iter; index++; return *this; }
+        constexpr iterator operator ++(int) { auto previous = *this; operator++(); return previous; }
+        constexpr bool operator !=(container_end_t const& last) const { return iter != last; }
+        //the element is referred to if the container hands out
+        //references, and copied if it hands out values
+        constexpr auto operator *() const { return utl::tuple<size_t,decltype(*iter)>{index, *iter}; }
     }; 
     struct enumerator {
-        decltype(container) c;
-        constexpr auto begin() { return iterator{0, utl::ranges::begin(c)}; }
-        constexpr auto end() { return iterator{0, utl::ranges::end(c)}; }
+        container_t c;
+        constexpr auto begin() const { return iterator{0, utl::ranges::begin(c)}; }
+        constexpr auto end() const { return utl::ranges::end(c); }
     };
     return enumerator{std::forward<T>(container)};
 };
@@ -99,7 +106,8 @@ template <is_reversable_iterator T>
 struct reverse_iterator {
     T active;
     constexpr auto operator *() const { return *active; }
-    constexpr void operator++() { active--; }
+    constexpr reverse_iterator& operator++() { active--; return *this; }
+    constexpr reverse_iterator operator++(int) { auto previous = *this; active--; return previous; }
     constexpr bool operator!=(reverse_iterator const& other) const { return active != other.active; }
 };
 
@@ -0,0 +1,553 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utility>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/tuple.hh>
+#include <utl/ranges.hh>
+
+namespace utl::ranges {
+
+//Lazy range adaptors. Each one wraps a range and does its work as it
+//is iterated, so nothing is copied into a temporary buffer and nothing
+//is allocated:
+//
+//    for(auto v : samples | filter(is_valid) | transform(to_mv) | take(8))
+//    for(auto [a, b] : zip(lhs, rhs))
+//    for(auto block : buffer | chunk(64))
+//
+//They can be called directly, as transform(samples, to_mv), or
+//without the range, to get something to pipe a range into.
+//
+//A range that's passed as an lvalue is referred to, and must outlive
+//the adaptor; a temporary is moved into the adaptor. Iterators refer
+//to the adaptor they came from (for its function, in transform and
+//filter), so they shouldn't outlive it either.
+//
+//An adaptor's end() is the end of the range it wraps, or a small
+//sentinel, rather than another iterator; its iterators compare against
+//that.
+
+namespace detail::adaptors {
+    //How an adaptor holds the range R it was given as R&&.
+    template <typename R>
+    using stored_t = std::conditional_t<std::is_lvalue_reference_v<R>,R,std::remove_cvref_t<R>>;
+
+    template <typename R>
+    using iterator_t = decltype(utl::ranges::begin(std::declval<R const&>()));
+
+    template <typename R>
+    using sentinel_t = decltype(utl::ranges::end(std::declval<R const&>()));
+
+    //Iterators that can jump straight to an element, as pointers can.
+    template <typename I, typename S>
+    concept random_access = requires(I iter, S last, size_t count) {
+        last - iter;
+        iter + count;
+        iter += count;
+    };
+
+    //Advances iter by up to count, stopping at last. Returns how far
+    //it went.
+    template <typename I, typename S>
+    constexpr size_t advance(I& iter, S const& last, size_t count)
+    {
+        //a step at a time, unless the distance to the end is known
+        if constexpr(random_access<I,S>) {
+            const auto remaining = static_cast<size_t>(last - iter);
+            if(count > remaining) count = remaining;
+            iter += count;
+            return count;
+        } else {
+            size_t done = 0;
+            for(; done < count and iter != last; done++) ++iter;
+            return done;
+        }
+    }
+
+    //What transform(fn) and friends return: a function waiting for a
+    //range, which is given to it with |.
+    template <typename F>
+    struct closure {
+        F apply;
+
+        template <iterable R>
+        friend constexpr auto operator|(R&& range, closure const& self)
+        {
+            return self.apply(std::forward<R>(range));
+        }
+    };
+
+    template <typename F>
+    closure(F) -> closure<F>;
+
+    //A pair of an iterator and its end, as a range.
+    template <typename I, typename S>
+    struct subrange {
+        I first;
+        S last;
+        [[nodiscard]] constexpr I begin() const { return first; }
+        [[nodiscard]] constexpr S end() const { return last; }
+    };
+
+    //The end of a range that doesn't have one.
+    struct unbounded {};
+
+    //The ranges a zip_view holds. These aren't kept in a utl::tuple,
+    //which would make a referred-to range const whenever the tuple is.
+    template <size_t I, typename R>
+    struct zip_base {
+        R base;
+    };
+
+    template <typename Is, typename... Rs>
+    struct zip_bases;
+
+    template <size_t... Is, typename... Rs>
+    struct zip_bases<std::index_sequence<Is...>,Rs...> : zip_base<Is,Rs>... {
+        constexpr explicit zip_bases(Rs&&... bases) : zip_base<Is,Rs>{std::forward<Rs>(bases)}... {}
+    };
+} //namespace detail::adaptors
+
+template <typename R, typename F>
+class transform_view {
+    using base_iterator_t = detail::adaptors::iterator_t<R>;
+    using base_sentinel_t = detail::adaptors::sentinel_t<R>;
+
+    R m_base;
+    F m_fn;
+
+public:
+    class iterator {
+        base_iterator_t m_current;
+        F const* m_fn;
+
+    public:
+        constexpr iterator(base_iterator_t current, F const* fn) : m_current{current}, m_fn{fn} {}
+
+        constexpr decltype(auto) operator*() const { return (*m_fn)(*m_current); }
+        constexpr iterator& operator++() { ++m_current; return *this; }
+        constexpr iterator operator++(int) { auto previous = *this; ++m_current; return previous; }
+        constexpr bool operator!=(base_sentinel_t const& last) const { return m_current != last; }
+    };
+
+    constexpr transform_view(R&& base, F fn) : m_base{std::forward<R>(base)}, m_fn{std::move(fn)} {}
+
+    [[nodiscard]] constexpr iterator begin() const { return {utl::ranges::begin(m_base), &m_fn}; }
+    [[nodiscard]] constexpr base_sentinel_t end() const { return utl::ranges::end(m_base); }
+};
+
+template <typename R, typename F>
+class filter_view {
+    using base_iterator_t = detail::adaptors::iterator_t<R>;
+    using base_sentinel_t = detail::adaptors::sentinel_t<R>;
+
+    R m_base;
+    F m_predicate;
+
+public:
+    class iterator {
+        base_iterator_t m_current;
+        base_sentinel_t m_last;
+        F const* m_predicate;
+
+        constexpr void skip()
+        {
+            while(m_current != m_last and not (*m_predicate)(*m_current)) ++m_current;
+        }
+
+    public:
+        constexpr iterator(base_iterator_t current, base_sentinel_t last, F const* predicate)
+            : m_current{current}, m_last{last}, m_predicate{predicate}
+        {
+            skip();
+        }
+
+        constexpr decltype(auto) operator*() const { return *m_current; }
+        constexpr iterator& operator++() { ++m_current; skip(); return *this; }
+        constexpr iterator operator++(int) { auto previous = *this; operator++(); return previous; }
+        constexpr bool operator!=(base_sentinel_t const& last) const { return m_current != last; }
+    };
+
+    constexpr filter_view(R&& base, F predicate) : m_base{std::forward<R>(base)}, m_predicate{std::move(predicate)} {}
+
+    [[nodiscard]] constexpr iterator begin() const
+    {
+        return {utl::ranges::begin(m_base), utl::ranges::end(m_base), &m_predicate};
+    }
+    [[nodiscard]] constexpr base_sentinel_t end() const { return utl::ranges::end(m_base); }
+};
+
+template <typename R>
+class take_view {
+    using base_iterator_t = detail::adaptors::iterator_t<R>;
+    using base_sentinel_t = detail::adaptors::sentinel_t<R>;
+
+    R m_base;
+    size_t m_count;
+
+public:
+    struct sentinel {
+        base_sentinel_t last;
+    };
+
+    class iterator {
+        base_iterator_t m_current;
+        size_t m_remaining;
+
+    public:
+        constexpr iterator(base_iterator_t current, size_t remaining) : m_current{current}, m_remaining{remaining} {}
+
+        constexpr decltype(auto) operator*() const { return *m_current; }
+        constexpr iterator& operator++() { ++m_current; m_remaining--; return *this; }
+        constexpr iterator operator++(int) { auto previous = *this; operator++(); return previous; }
+        constexpr bool operator!=(sentinel const& end) const
+        {
+            return m_remaining != 0 and m_current != end.last;
+        }
+    };
+
+    constexpr take_view(R&& base, size_t count) : m_base{std::forward<R>(base)}, m_count{count} {}
+
+    [[nodiscard]] constexpr iterator begin() const { return {utl::ranges::begin(m_base), m_count}; }
+    [[nodiscard]] constexpr sentinel end() const { return {utl::ranges::end(m_base)}; }
+};
+
+template <typename R>
+class drop_view {
+    using base_iterator_t = detail::adaptors::iterator_t<R>;
+    using base_sentinel_t = detail::adaptors::sentinel_t<R>;
+
+    R m_base;
+    size_t m_count;
+
+public:
+    constexpr drop_view(R&& base, size_t count) : m_base{std::forward<R>(base)}, m_count{count} {}
+
+    //The elements that are dropped are skipped over each time begin()
+    //is called.
+    [[nodiscard]] constexpr base_iterator_t begin() const
+    {
+        auto first = utl::ranges::begin(m_base);
+        detail::adaptors::advance(first, utl::ranges::end(m_base), m_count);
+        return first;
+    }
+    [[nodiscard]] constexpr base_sentinel_t end() const { return utl::ranges::end(m_base); }
+};
+
+template <typename R>
+class stride_view {
+    using base_iterator_t = detail::adaptors::iterator_t<R>;
+    using base_sentinel_t = detail::adaptors::sentinel_t<R>;
+
+    static constexpr bool indexed = detail::adaptors::random_access<base_iterator_t,base_sentinel_t>;
+
+    R m_base;
+    size_t m_step;
+
+public:
+    //Over something like an array, the iterator counts an index up to
+    //the size, which optimizes just like a hand-written loop; stepping
+    //the iterator itself, and checking for the end at each step, keeps
+    //the loop from being vectorized.
+    class iterator {
+        base_iterator_t m_current;
+        base_sentinel_t m_last;
+        size_t m_step;
+        size_t m_index = 0;
+        size_t m_size = 0;
+
+    public:
+        constexpr iterator(base_iterator_t current, base_sentinel_t last, size_t step)
+            : m_current{current}, m_last{last}, m_step{step}
+        {
+            if constexpr(indexed) m_size = static_cast<size_t>(last - current);
+        }
+
+        constexpr decltype(auto) operator*() const
+        {
+            if constexpr(indexed) {
+                return *(m_current + m_index); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            } else {
+                return *m_current;
+            }
+        }
+
+        constexpr iterator& operator++()
+        {
+            if constexpr(indexed) {
+                m_index += m_step;
+            } else {
+                detail::adaptors::advance(m_current, m_last, m_step);
+            }
+            return *this;
+        }
+
+        constexpr iterator operator++(int) { auto previous = *this; operator++(); return previous; }
+
+        constexpr bool operator!=(base_sentinel_t const& last) const
+        {
+            if constexpr(indexed) {
+                return m_index < m_size;
+            } else {
+                return m_current != last;
+            }
+        }
+    };
+
+    constexpr stride_view(R&& base, size_t step) : m_base{std::forward<R>(base)}, m_step{step} {}
+
+    [[nodiscard]] constexpr iterator begin() const
+    {
+        return {utl::ranges::begin(m_base), utl::ranges::end(m_base), m_step};
+    }
+    [[nodiscard]] constexpr base_sentinel_t end() const { return utl::ranges::end(m_base); }
+};
+
+//Each chunk is itself a range, of up to size elements.
+template <typename R>
+class chunk_view {
+    using base_iterator_t = detail::adaptors::iterator_t<R>;
+    using base_sentinel_t = detail::adaptors::sentinel_t<R>;
+    using chunk_t = take_view<detail::adaptors::subrange<base_iterator_t,base_sentinel_t>>;
+
+    R m_base;
+    size_t m_size;
+
+public:
+    class iterator {
+        base_iterator_t m_current;
+        base_sentinel_t m_last;
+        size_t m_size;
+
+    public:
+        constexpr iterator(base_iterator_t current, base_sentinel_t last, size_t size)
+            : m_current{current}, m_last{last}, m_size{size}
+        {}
+
+        constexpr chunk_t operator*() const { return {{m_current, m_last}, m_size}; }
+        constexpr iterator& operator++()
+        {
+            detail::adaptors::advance(m_current, m_last, m_size);
+            return *this;
+        }
+        constexpr iterator operator++(int) { auto previous = *this; operator++(); return previous; }
+        constexpr bool operator!=(base_sentinel_t const& last) const { return m_current != last; }
+    };
+
+    constexpr chunk_view(R&& base, size_t size) : m_base{std::forward<R>(base)}, m_size{size} {}
+
+    [[nodiscard]] constexpr iterator begin() const
+    {
+        return {utl::ranges::begin(m_base), utl::ranges::end(m_base), m_size};
+    }
+    [[nodiscard]] constexpr base_sentinel_t end() const { return utl::ranges::end(m_base); }
+};
+
+//Elements are tuples of the elements of each range, and the zipped
+//range ends with the shortest of them.
+template <typename... Rs>
+class zip_view {
+    using indices_t = std::index_sequence_for<Rs...>;
+
+    detail::adaptors::zip_bases<indices_t,Rs...> m_bases;
+
+public:
+    struct sentinel {
+        utl::tuple<detail::adaptors::sentinel_t<Rs>...> lasts;
+    };
+
+    class iterator {
+        utl::tuple<detail::adaptors::iterator_t<Rs>...> m_currents;
+
+        template <size_t... Is>
+        constexpr auto dereference(std::index_sequence<Is...>) const
+        {
+            return utl::tuple<decltype(*utl::get<Is>(m_currents))...>{*utl::get<Is>(m_currents)...};
+        }
+
+        template <size_t... Is>
+        constexpr void increment(std::index_sequence<Is...>)
+        {
+            (++utl::get<Is>(m_currents), ...);
+        }
+
+        template <size_t... Is>
+        constexpr bool none_ended(sentinel const& end, std::index_sequence<Is...>) const
+        {
+            return ((utl::get<Is>(m_currents) != utl::get<Is>(end.lasts)) and ...);
+        }
+
+    public:
+        constexpr explicit iterator(detail::adaptors::iterator_t<Rs>... currents) : m_currents{currents...} {}
+
+        constexpr auto operator*() const { return dereference(indices_t{}); }
+        constexpr iterator& operator++() { increment(indices_t{}); return *this; }
+        constexpr iterator operator++(int) { auto previous = *this; operator++(); return previous; }
+        constexpr bool operator!=(sentinel const& end) const { return none_ended(end, indices_t{}); }
+    };
+
+    constexpr explicit zip_view(Rs&&... bases) : m_bases{std::forward<Rs>(bases)...} {}
+
+    [[nodiscard]] constexpr iterator begin() const { return begin(indices_t{}); }
+    [[nodiscard]] constexpr sentinel end() const { return end(indices_t{}); }
+
+private:
+    template <size_t... Is>
+    [[nodiscard]] constexpr iterator begin(std::index_sequence<Is...>) const
+    {
+        return iterator{utl::ranges::begin(static_cast<detail::adaptors::zip_base<Is,Rs> const&>(m_bases).base)...};
+    }
+
+    template <size_t... Is>
+    [[nodiscard]] constexpr sentinel end(std::index_sequence<Is...>) const
+    {
+        return {{utl::ranges::end(static_cast<detail::adaptors::zip_base<Is,Rs> const&>(m_bases).base)...}};
+    }
+};
+
+//Counts from first up to (not including) last, or forever.
+template <typename T, typename S = T>
+class iota_view {
+    T m_first;
+    S m_last;
+
+public:
+    class iterator {
+        T m_value;
+
+    public:
+        constexpr explicit iterator(T value) : m_value{value} {}
+
+        constexpr T operator*() const { return m_value; }
+        constexpr iterator& operator++() { ++m_value; return *this; }
+        constexpr iterator operator++(int) { auto previous = *this; ++m_value; return previous; }
+        constexpr bool operator!=(S const& last) const
+        {
+            if constexpr(std::is_same_v<S,detail::adaptors::unbounded>) {
+                return true;
+            } else {
+                return m_value != last;
+            }
+        }
+    };
+
+    constexpr iota_view(T first, S last) : m_first{first}, m_last{last} {}
+
+    [[nodiscard]] constexpr iterator begin() const { return iterator{m_first}; }
+    [[nodiscard]] constexpr S end() const { return m_last; }
+};
+
+template <iterable R, typename F>
+constexpr auto transform(R&& range, F fn)
+{
+    using stored_t = detail::adaptors::stored_t<R>;
+    return transform_view<stored_t,F>{std::forward<R>(range), std::move(fn)};
+}
+
+template <typename F>
+constexpr auto transform(F fn)
+{
+    return detail::adaptors::closure{[fn](auto&& range) {
+        return utl::ranges::transform(std::forward<decltype(range)>(range), fn);
+    }};
+}
+
+template <iterable R, typename F>
+constexpr auto filter(R&& range, F predicate)
+{
+    using stored_t = detail::adaptors::stored_t<R>;
+    return filter_view<stored_t,F>{std::forward<R>(range), std::move(predicate)};
+}
+
+template <typename F>
+constexpr auto filter(F predicate)
+{
+    return detail::adaptors::closure{[predicate](auto&& range) {
+        return utl::ranges::filter(std::forward<decltype(range)>(range), predicate);
+    }};
+}
+
+//The first count elements, or all of them if there are fewer.
+template <iterable R>
+constexpr auto take(R&& range, size_t count)
+{
+    return take_view<detail::adaptors::stored_t<R>>{std::forward<R>(range), count};
+}
+
+constexpr auto take(size_t count)
+{
+    return detail::adaptors::closure{[count](auto&& range) {
+        return utl::ranges::take(std::forward<decltype(range)>(range), count);
+    }};
+}
+
+//All but the first count elements.
+template <iterable R>
+constexpr auto drop(R&& range, size_t count)
+{
+    return drop_view<detail::adaptors::stored_t<R>>{std::forward<R>(range), count};
+}
+
+constexpr auto drop(size_t count)
+{
+    return detail::adaptors::closure{[count](auto&& range) {
+        return utl::ranges::drop(std::forward<decltype(range)>(range), count);
+    }};
+}
+
+//Every step'th element, starting with the first. step must not be 0.
+template <iterable R>
+constexpr auto stride(R&& range, size_t step)
+{
+    return stride_view<detail::adaptors::stored_t<R>>{std::forward<R>(range), step};
+}
+
+constexpr auto stride(size_t step)
+{
+    return detail::adaptors::closure{[step](auto&& range) {
+        return utl::ranges::stride(std::forward<decltype(range)>(range), step);
+    }};
+}
+
+//Consecutive chunks of size elements; the last may be shorter. size
+//must not be 0.
+template <iterable R>
+constexpr auto chunk(R&& range, size_t size)
+{
+    return chunk_view<detail::adaptors::stored_t<R>>{std::forward<R>(range), size};
+}
+
+constexpr auto chunk(size_t size)
+{
+    return detail::adaptors::closure{[size](auto&& range) {
+        return utl::ranges::chunk(std::forward<decltype(range)>(range), size);
+    }};
+}
+
+template <iterable... Rs>
+constexpr auto zip(Rs&&... ranges)
+{
+    return zip_view<detail::adaptors::stored_t<Rs>...>{std::forward<Rs>(ranges)...};
+}
+
+template <typename T>
+constexpr auto iota(T first, T last)
+{
+    return iota_view<T>{first, last};
+}
+
+template <typename T>
+constexpr auto iota(T first)
+{
+    return iota_view<T,detail::adaptors::unbounded>{first, {}};
+}
+
+} //namespace utl::ranges
@@ -0,0 +1,196 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utl/utl.hh>
+#include <utl/string-view.hh>
+#include <utl/bits/string_search.hh>
+
+namespace utl::ranges {
+
+//Ranges of string_view slices of a string, found lazily as the range
+//is iterated: nothing is copied, and nothing is stored but the string
+//and the delimiter.
+//
+//    for(auto field : utl::ranges::split("a,b,,c"_sv, ','))       //"a" "b" "" "c"
+//    for(auto token : utl::ranges::tokenize("  set  rate 10 "_sv)) //"set" "rate" "10"
+//    for(auto line : utl::ranges::lines("one\r\ntwo\n"_sv))        //"one" "two"
+//
+//The slices point into the original string, which must outlive them.
+
+namespace detail::split {
+    //A delimiter is found by find(data, size, pos), which returns the
+    //position of the next delimiter at or after pos (or npos), and is
+    //length() characters long.
+
+    struct by_char {
+        char delimiter;
+        [[nodiscard]] constexpr size_t find(const char* data, size_t size, size_t pos) const
+        {
+            return search::find(data, size, &delimiter, 1, pos);
+        }
+        static constexpr size_t length() { return 1; }
+    };
+
+    struct by_string {
+        const char* delimiter;
+        size_t delimiter_length;
+        [[nodiscard]] constexpr size_t find(const char* data, size_t size, size_t pos) const
+        {
+            //an empty delimiter never matches, rather than matching everywhere
+            if(delimiter_length == 0) return npos;
+            return search::find(data, size, delimiter, delimiter_length, pos);
+        }
+        [[nodiscard]] constexpr size_t length() const { return delimiter_length; }
+    };
+
+    struct by_any {
+        search::char_set set;
+        [[nodiscard]] constexpr size_t find(const char* data, size_t size, size_t pos) const
+        {
+            return search::find_any(data, size, set, pos);
+        }
+        [[nodiscard]] constexpr size_t skip(const char* data, size_t size, size_t pos) const
+        {
+            return search::find_any<false>(data, size, set, pos);
+        }
+        static constexpr size_t length() { return 1; }
+    };
+
+    enum class mode : uint8_t {
+        fields, //every field, including empty ones
+        tokens, //runs of delimiters are one separator; no empty fields
+        lines   //a final empty field is dropped, as is a '\r' before each '\n'
+    };
+} //namespace detail::split
+
+template <typename Delimiter, detail::split::mode Mode = detail::split::mode::fields>
+class split_view {
+    using mode = detail::split::mode;
+
+    const char* m_data;
+    size_t m_size;
+    Delimiter m_delimiter;
+
+public:
+    //Iterators hold their own copy of the string and delimiter, so
+    //they stay valid when the range itself is a temporary.
+    class iterator {
+        const char* m_data;
+        size_t m_size;
+        Delimiter m_delimiter;
+        size_t m_start; //npos once past the last field
+        size_t m_stop;
+
+        constexpr void find_from(size_t pos)
+        {
+            if constexpr(Mode == mode::tokens) {
+                pos = m_delimiter.skip(m_data, m_size, pos);
+                if(pos == npos) {
+                    m_start = npos;
+                    return;
+                }
+            } else if constexpr(Mode == mode::lines) {
+                if(pos == m_size) {
+                    m_start = npos;
+                    return;
+                }
+            }
+            m_start = pos;
+            const auto found = m_delimiter.find(m_data, m_size, pos);
+            m_stop = found == npos ? m_size : found;
+        }
+
+    public:
+        constexpr iterator() : m_data{nullptr}, m_size{0}, m_delimiter{}, m_start{npos}, m_stop{npos} {}
+
+        constexpr explicit iterator(split_view const& view)
+            : m_data{view.m_data}, m_size{view.m_size}, m_delimiter{view.m_delimiter}, m_start{npos}, m_stop{npos}
+        {
+            //an empty string has no fields
+            if(m_size != 0) find_from(0);
+        }
+
+        constexpr string_view operator*() const
+        {
+            size_t stop = m_stop;
+            if constexpr(Mode == mode::lines) {
+                if(stop > m_start and m_data[stop - 1] == '\r') stop--; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            }
+            return {m_data + m_start, stop - m_start}; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        constexpr iterator& operator++()
+        {
+            if(m_stop == m_size) {
+                m_start = npos;
+            } else {
+                find_from(m_stop + m_delimiter.length());
+            }
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto previous = *this;
+            operator++();
+            return previous;
+        }
+
+        constexpr bool operator==(iterator const& other) const
+        {
+            return m_start == other.m_start;
+        }
+    };
+
+    constexpr split_view(string_view text, Delimiter delimiter)
+        : m_data{text.data()}, m_size{text.size()}, m_delimiter{delimiter}
+    {}
+
+    [[nodiscard]] constexpr iterator begin() const { return iterator{*this}; }
+    [[nodiscard]] constexpr iterator end() const { return {}; }
+
+    [[nodiscard]] constexpr bool empty() const { return begin() == end(); }
+};
+
+//Fields separated by delimiter, including empty ones: "a,,b" has
+//three fields, and "a," has two.
+constexpr auto split(string_view text, char delimiter)
+{
+    return split_view<detail::split::by_char>{text, {delimiter}};
+}
+
+//A delimiter of more than one character. An empty delimiter splits
+//nothing.
+constexpr auto split(string_view text, string_view delimiter)
+{
+    return split_view<detail::split::by_string>{text, {delimiter.data(), delimiter.size()}};
+}
+
+//Fields separated by any one of the characters in delimiters.
+constexpr auto split_any(string_view text, string_view delimiters)
+{
+    return split_view<detail::split::by_any>{text, {{delimiters.data(), delimiters.size()}}};
+}
+
+//Tokens separated by runs of any of the characters in delimiters;
+//leading and trailing delimiters are ignored.
+constexpr auto tokenize(string_view text, string_view delimiters = " \t\r\n")
+{
+    return split_view<detail::split::by_any,detail::split::mode::tokens>{text,
+        {{delimiters.data(), delimiters.size()}}};
+}
+
+//Lines ending in "\n" or "\r\n", without their line endings. The last
+//line needn't be terminated.
+constexpr auto lines(string_view text)
+{
+    return split_view<detail::split::by_char,detail::split::mode::lines>{text, {'\n'}};
+}
+
+} //namespace utl::ranges
@@ -45,7 +45,7 @@ template <typename T>
 using value_t = typename std::decay_t<T>::value_t;
 
 template <typename T>
-using register_value_t = value_t<register_t<T>>;
+using register_value_t = registers::value_t<register_t<T>>;
 
 template <typename T>
 concept any_field = requires(T r) {
@@ -57,16 +57,28 @@ concept any_field = requires(T r) {
 template <typename T, typename R>
 concept any_field_of = any_field<T> and same_register_as<R,register_t<T>>;
 
+//the field's bits, in register position.
+constexpr auto mask(any_field auto f) -> register_value_t<decltype(f)>
+{
+    using register_value = register_value_t<decltype(f)>;
+    constexpr auto register_width = registers::width<register_t<decltype(f)>>();
+    const auto ones = f.width() == register_width ? static_cast<register_value>(~register_value{0}) :
+        static_cast<register_value>((register_value{1} << f.width()) - 1);
+    return static_cast<register_value>(ones << f.offset());
+}
+
 constexpr auto align_to_register(any_field auto f, value_t<decltype(f)> v) -> register_value_t<decltype(f)>
 {
-    //since we're using fixed width integers, masking isn't necessary. I think.
-    return v << f.offset();
+    //the field's value type is only as wide as the field, so widen
+    //before shifting or the value is shifted out entirely.
+    using register_value = register_value_t<decltype(f)>;
+    const auto widened = static_cast<register_value>(v);
+    return static_cast<register_value>((widened << f.offset()) & mask(f));
 }
 
 constexpr auto align_from_register(any_field auto f, register_value_t<decltype(f)> v) -> value_t<decltype(f)>
 {
-    //since we're using fixed width integers, masking isn't necessary. I think.
-    return v >> f.offset();
+    return static_cast<value_t<decltype(f)>>((v & mask(f)) >> f.offset());
 }
 
 template <any_register R, size_t Offset, size_t Width>
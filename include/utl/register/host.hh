@@ -0,0 +1,115 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utl/array.hh>
+#include <utl/span.hh>
+#include <utl/integer.hh>
+#include <utl/register/register.hh>
+
+//A register backend for host builds. Registers live in an in-memory
+//register file that records every access, so tests can check how
+//many MMIO accesses a driver makes and in what order.
+namespace utl::registers::host {
+
+enum class direction : uint8_t {
+    read,
+    write
+};
+
+struct access {
+    uintptr_t address;
+    size_t width;
+    uint64_t value;
+    direction dir;
+};
+
+class register_file {
+public:
+    static constexpr size_t max_registers = 64;
+    static constexpr size_t max_accesses = 256;
+
+    //Registers that haven't been written read as their reset value.
+    uint64_t read(uintptr_t address, size_t width, uint64_t reset_value);
+    void write(uintptr_t address, size_t width, uint64_t value);
+
+    //Inspect or preload a register without recording an access.
+    [[nodiscard]] uint64_t peek(uintptr_t address, uint64_t reset_value = 0) const;
+    void poke(uintptr_t address, uint64_t value);
+
+    //The first max_accesses accesses since the trace was last
+    //cleared. The counts below keep going after the trace fills;
+    //count() only misses accesses to registers past max_registers,
+    //which overflowed() also reports.
+    [[nodiscard]] span<access const> trace() const { return {m_trace.data(), m_n_accesses}; }
+    [[nodiscard]] size_t reads() const { return m_reads; }
+    [[nodiscard]] size_t writes() const { return m_writes; }
+    [[nodiscard]] size_t accesses() const { return m_reads + m_writes; }
+    [[nodiscard]] size_t count(uintptr_t address, direction dir) const;
+    [[nodiscard]] bool overflowed() const { return accesses() > m_n_accesses or m_dropped_registers; }
+
+    void clear_trace();
+    //forget register values too
+    void reset();
+
+private:
+    struct cell {
+        uintptr_t address;
+        uint64_t value;
+        size_t reads;
+        size_t writes;
+    };
+
+    [[nodiscard]] cell const* find(uintptr_t address) const;
+    cell* find_or_insert(uintptr_t address, uint64_t reset_value);
+    void record(cell* c, uintptr_t address, size_t width, uint64_t value, direction dir);
+
+    array<cell,max_registers> m_cells{};
+    size_t m_n_cells = 0;
+    bool m_dropped_registers = false;
+    array<access,max_accesses> m_trace{};
+    size_t m_n_accesses = 0;
+    size_t m_reads = 0;
+    size_t m_writes = 0;
+};
+
+//The register file mock registers use. There's always one; until a
+//file is pushed, it's a default instance.
+register_file& get_register_file();
+
+struct push_register_file {
+    push_register_file(register_file& file);
+    push_register_file(push_register_file const&) = delete;
+    push_register_file& operator=(push_register_file const&) = delete;
+    ~push_register_file();
+private:
+    register_file* m_previous_file;
+};
+
+template <uintptr_t Address, size_t Width = 32, uint64_t Reset = 0>
+struct mock_register {
+    using value_type = uintn_t<Width>;
+
+    static constexpr size_t width() { return Width; }
+    static constexpr value_type reset_value() { return static_cast<value_type>(Reset); }
+    static constexpr uintptr_t address() { return Address; }
+
+    friend value_type tag_invoke(read_t, mock_register)
+    {
+        return static_cast<value_type>(get_register_file().read(Address, Width, Reset));
+    }
+
+    friend void tag_invoke(write_t, mock_register, value_type v)
+    {
+        get_register_file().write(Address, Width, static_cast<uint64_t>(v));
+    }
+};
+
+} //namespace utl::registers::host
@@ -8,421 +8,377 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <utility>
+#include <concepts>
+#include <type_traits>
 #include <utl/register/register.hh>
 #include <utl/register/field.hh>
-#include <utl/hof.hh>
-
-
-
-
-
-
-
-template <any_field T>
-struct bit_manipulate {
-    utl::register::value_t<T> set;    
-    utl::register::value_t<T> clr;
-
-    consteval auto operator()(any_register auto&& r, utl::register::value_t<T> v)
-    {
-        static_assert(utl::registers::contains_field<decltype(r),T>());
-        return utl::tuple{r, (v | field::apply_offset());
-    }
-};
-
-
-
-
-
-
-
-
+#include <utl/array.hh>
+#include <utl/tuple.hh>
+#include <utl/type-list.hh>
 
 namespace utl::registers::ops {
 
 BFG_TAG_INVOKE_DEF(merge);
 BFG_TAG_INVOKE_DEF(evaluate);
 
-// constexpr auto tag_invoke(merge_t, any_field_op auto...)
-// {
-    
-// }
-
-
 template <typename T>
 using target_register_t = typename std::decay_t<T>::target_register_t;
 
 template <typename T>
-using target_value_t = typename target_register_t<T>::value_t;
+using target_value_t = registers::value_t<target_register_t<T>>;
 
 template <typename T>
 concept has_target_register = requires {
-    typename T::target_register_t;
-} and any_register<typename T::target_register_t>;
-
+    typename std::decay_t<T>::target_register_t;
+} and any_register<typename std::decay_t<T>::target_register_t>;
 
+//an op computes a register's new value from its current one.
+//evaluating an op never touches the register; apply() does that.
 template <typename T>
 concept any_op = has_target_register<T> and
     requires(T o, target_register_t<T> r, target_value_t<T> v) {
         { evaluate(r,v,o) } -> std::same_as<decltype(v)>;
-        //ops are comparable
     };
 
-namespace composed {
-
-    // template <typename T>
-    // consteval bool detect_composed_ops() { return false; }
-
-    // template <any_tuple T, size_t... Is>
-    // consteval bool detect_composed_ops_fold(std::index_sequence<Is...>)
-    // {
-    //     return (detect_composed_ops<utl::tuple_element_t<Is,T>>() and ...);
-    // }
-
-    // template <any_tuple T>
-    // consteval bool detect_composed_ops()
-    // {
-    //     return detect_composed_ops_fold<T>(std::make_index_sequence<utl::tuple_size_v<T>>);
-    // }
+template <typename T>
+concept any_field_op = any_op<T> and requires {
+    typename std::decay_t<T>::target_field_t;
+};
 
-    // template <any_op T>
-    // consteval bool detect_composed_ops()
-    // {
-    //     return true;
-    // }
+template <any_register R>
+struct bitwise_modify_register {
+    using target_register_t = R;
+    using value_t = registers::value_t<R>;
+    R target;
+    value_t set_mask;
+    value_t clear_mask;
 
-    // template <size_t I, size_t... Is>
-    // constexpr auto eval(const any_register auto r, const auto v, any_composed_ops auto o)
-    // {
-    //     return utl::get<I>(r)
-    // }
+    //the bits this op type may change
+    static constexpr uint64_t touched_mask() { return ~uint64_t{0}; }
 
+    friend constexpr value_t tag_invoke(evaluate_t, R, value_t v, bitwise_modify_register a)
+    {
+        return static_cast<value_t>((v | a.set_mask) & static_cast<value_t>(~a.clear_mask));
+    }
 
+    //b is applied after a, so where they disagree b wins.
+    friend constexpr auto tag_invoke(merge_t, bitwise_modify_register a, bitwise_modify_register b)
+    {
+        return bitwise_modify_register{
+            b.target,
+            static_cast<value_t>((a.set_mask | b.set_mask) & static_cast<value_t>(~b.clear_mask)),
+            static_cast<value_t>((a.clear_mask | b.clear_mask) & static_cast<value_t>(~b.set_mask))
+        };
+    }
+};
 
+template <field::any_field T>
+struct bitwise_modify_field {
+    using target_field_t = T;
+    using target_register_t = field::register_t<T>;
+    using value_t = field::value_t<T>;
+    using register_value_t = field::register_value_t<T>;
+    T target;
+    value_t set_mask;
+    value_t clear_mask;
 
-    BFG_TAG_INVOKE_DEF(flatten_operator);
+    static constexpr uint64_t touched_mask() { return static_cast<uint64_t>(field::mask(T{})); }
 
-    constexpr auto tag_invoke(flatten_operator_t, auto&& v, any_tuple auto&& accumulated)
+    constexpr auto lower() const
     {
-        using value_t = decltype(v);
-        using accum_t = decltype(accumulated);
-        return utl::tuple_cat(tuple{std::forward<value_t>(v)}, std::forward<accum_t>(accumulated));
+        return bitwise_modify_register<target_register_t>{
+            target_register_t{},
+            field::align_to_register(target, set_mask),
+            field::align_to_register(target, clear_mask)
+        };
     }
 
-    constexpr auto tag_invoke(flatten_operator_t, any_tuple auto&& v, any_tuple auto&& accumulated)
+    friend constexpr register_value_t tag_invoke(evaluate_t, target_register_t r, register_value_t v, bitwise_modify_field a)
     {
-        using value_t = decltype(v);
-        using accum_t = decltype(accumulated);
-        return hof::fold(std::forward<value_t>(v), flatten_operator, 
-            std::forward<accum_t>(accumulated)
-        );
+        return evaluate(r, v, a.lower());
     }
 
-    constexpr auto flatten(any_tuple auto&& composition)
+    friend constexpr auto tag_invoke(merge_t, bitwise_modify_field a, bitwise_modify_register<target_register_t> b)
     {
-        using comp_t = decltype(composition);
-        return hof::fold(std::forward<comp_t>(composition), flatten_operator, utl::tuple{});
+        return merge(a.lower(), b);
     }
 
+    friend constexpr auto tag_invoke(merge_t, bitwise_modify_register<target_register_t> a, bitwise_modify_field b)
+    {
+        return merge(a, b.lower());
+    }
+};
 
+constexpr auto assign(field::any_field auto f, field::value_t<decltype(f)> v)
+{
+    using value_t = field::value_t<decltype(f)>;
+    return bitwise_modify_field<decltype(f)>{f, v, static_cast<value_t>(~v)};
+}
 
+constexpr auto set(field::any_field auto f)
+{
+    using value_t = field::value_t<decltype(f)>;
+    return bitwise_modify_field<decltype(f)>{f, static_cast<value_t>(~value_t{0}), value_t{0}};
+}
 
-    BFG_TAG_INVOKE_DEF(merge_sort_operator);
-
-    template <typename T>
-    struct merge_state {
+constexpr auto clear(field::any_field auto f)
+{
+    using value_t = field::value_t<decltype(f)>;
+    return bitwise_modify_field<decltype(f)>{f, value_t{0}, static_cast<value_t>(~value_t{0})};
+}
 
+//an op that can be folded into a single write of its register.
+template <typename T>
+concept any_mergeable_op = any_op<T> and 
+    requires(bitwise_modify_register<target_register_t<T>> accum, std::decay_t<T> o) {
+        { merge(accum, o) } -> std::same_as<bitwise_modify_register<target_register_t<T>>>;
     };
 
-    template <typename... Ts>
-    merge_state(Ts&&...) -> merge_state<Ts&&...>;
-
-    // template<class T, T... Ints>
-    // constexpr T get(std::integer_sequence<T, Ints...>, std::size_t i) {
-    //     constexpr T arr[] = {Ints...};
-    //     return arr[i];
-    // }
-
-
-    // consteval auto merge(any_tuple auto&& accum, any_tuple auto&& a, any_tuple auto&& b)
-    // {
-    //     using a_head_t = std::decay_t<decltype(get<0>(a))>;
-    //     using b_head_t = std::decay_t<decltype(get<0>(b))>;
-
-    //     constexpr auto compare = [](auto&& state, auto&& a, auto&& b)
-    //     {
-    //         return state.get(a) <=> state.get(b);
-    //     };
-
-
-    //     if constexpr(compare(state,get<0>(a), get<0>(b)) == std::partial_ordering::less) {
-    //         return tuple_cat(tuple{get<0>(a)}, accum, merge());
-    //     } else {
-
-    //     }
-
-    //     // return hof::fold(std::forward<a_t>(a), merge_op, utl::tuple{});
-    // }
+namespace composed {
 
+    template <typename T>
+    struct is_composition : std::false_type {};
 
-    // constexpr auto tag_invoke(merge_sort_operator_t, auto&& merge_state, auto&& item)
-    // {
-    //     // using stack_t = std::decay_t<decltype(merge_state.stack)>;
-    //     // if constexpr()
+    template <typename... Ts>
+    struct is_composition<tuple<Ts...>> : std::true_type {};
 
-        
-        
-    // }
+    template <typename T>
+    concept any_composition = is_composition<std::decay_t<T>>::value;
 
-    constexpr auto sort(any_tuple auto&& composition)
+    constexpr auto flatten(auto&& op)
     {
-        using comp_t = std::decay_t<decltype(composition)>;
-
-        constexpr auto push_stack = [](any_tuple auto&& stack, auto&& item)
-        {
-            using item_t = std::decay_t<decltype(item)>;
-            return tuple_cat(tuple{std::forward<item_t>(item)}, stack);
-        };
-
-        constexpr auto get_stack_tail = []<size_t I, size_t... Is>(any_tuple auto&& stack)
-        {
-            return tuple{get<Is>(stack)...};
-        };
-
-        constexpr auto pop_stack = [](any_tuple auto&& stack)
-        {
-            return get<0>(stack), get_stack_tail(stack);
-        };
-
-        constexpr auto do_comparison = [](size_t, size_t)
-        {
-            return std::weak_ordering::equivalent;
-        };
+        return tuple<std::decay_t<decltype(op)>>{std::forward<decltype(op)>(op)};
+    }
 
-        constexpr auto do_merge = [](any_tuple auto&& stack, auto&&, auto&&)
-        {
-            return stack;
-        };
+    //nested compositions are spliced in place, so the result keeps
+    //the order in which the ops were written.
+    constexpr auto flatten(any_composition auto&& composition)
+    {
+        return utl::apply([](auto&&... items) {
+            return tuple_cat(tuple<>{}, tuple<>{}, flatten(std::forward<decltype(items)>(items))...);
+        }, std::forward<decltype(composition)>(composition));
+    }
 
-        constexpr auto sort_operator = [](any_tuple auto&& stack, auto&& item)
-        {
-            using item_t = std::decay_t<decltype(item)>;
+    template <typename T>
+    using flattened_t = decltype(flatten(std::declval<T>()));
 
-            constexpr size_t top_size = tuple_size_v<std::decay_t<decltype(get<0>(stack))>>;
+    template <typename T>
+    struct all_mergeable : std::false_type {};
 
-            if constexpr(top_size == 1) {
-                auto [top,new_stack] = pop_stack(stack);
-                return do_merge(new_stack, top, std::forward<item_t>(item));
-            } else {
-                return push_stack(stack,std::forward<item_t>(item));
+    template <typename... Ts>
+    struct all_mergeable<tuple<Ts...>> : std::bool_constant<(any_mergeable_op<Ts> and ...)> {};
+
+    //Partitions a flattened composition by target register. Registers
+    //are visited in the order they're first mentioned, and within a
+    //register the ops keep their relative order.
+    template <typename... Rs>
+    struct register_groups {
+        static constexpr size_t n_ops = sizeof...(Rs);
+        static_assert(n_ops > 0, "nothing to apply");
+
+        //index of the first op that targets the same register
+        static constexpr utl::array<size_t,n_ops> leaders{{find_type_index_v<Rs,Rs...>...}};
+
+        static constexpr size_t n_groups = []() {
+            size_t count = 0;
+            for(size_t idx = 0; idx < n_ops; idx++) {
+                if(leaders[idx] == idx) count++;
             }
-        };
+            return count;
+        }();
+
+        static constexpr utl::array<size_t,n_groups> group_leaders = []() {
+            utl::array<size_t,n_groups> result{};
+            size_t count = 0;
+            for(size_t idx = 0; idx < n_ops; idx++) {
+                if(leaders[idx] == idx) result[count++] = idx;
+            }
+            return result;
+        }();
+
+        template <size_t G>
+        static constexpr size_t group_size = []() {
+            size_t count = 0;
+            for(size_t idx = 0; idx < n_ops; idx++) {
+                if(leaders[idx] == group_leaders[G]) count++;
+            }
+            return count;
+        }();
+
+        template <size_t G>
+        static constexpr utl::array<size_t,group_size<G>> members = []() {
+            utl::array<size_t,group_size<G>> result{};
+            size_t count = 0;
+            for(size_t idx = 0; idx < n_ops; idx++) {
+                if(leaders[idx] == group_leaders[G]) result[count++] = idx;
+            }
+            return result;
+        }();
+    };
 
+    template <typename T>
+    struct groups_of;
 
-        
-        auto sorted_idxs = hof::fold(std::forward<comp_t>(composition), sort_operator, utl::tuple{});
-        static_assert(tuple_size_v<decltype(sorted_idxs)> == tuple_size_v<comp_t>);
+    template <typename... Ts>
+    struct groups_of<tuple<Ts...>> {
+        using type = register_groups<target_register_t<Ts>...>;
+    };
 
-        constexpr auto make_sort_result = []<size_t... Is>(auto&& comp, auto&& idxs, std::index_sequence<Is...>)
-        {
-            using result_t = tuple<tuple_element_t<get<Is>(idxs),std::decay_t<decltype(comp)>>...>;
-            return result_t{get<get<Is>(idxs)>>(comp)...};
-        };
+    template <typename T>
+    using groups_of_t = typename groups_of<std::decay_t<T>>::type;
 
-        return make_sort_result(
-            std::forward<comp_t>(composition), 
-            sorted_idxs, 
-            std::make_index_sequence<tuple_size_v<comp_t>>{}
-        );
+    //Folds every op in group G into one bitwise_modify_register.
+    template <size_t G>
+    constexpr auto merge_group(any_tuple auto const& ops)
+    {
+        using groups_t = groups_of_t<decltype(ops)>;
+        constexpr auto& members = groups_t::template members<G>;
+        using register_t = target_register_t<tuple_element_t<members[0],std::decay_t<decltype(ops)>>>;
+        using value_t = registers::value_t<register_t>;
+
+        return [&]<size_t... Is>(std::index_sequence<Is...>) {
+            auto merged = bitwise_modify_register<register_t>{register_t{}, value_t{0}, value_t{0}};
+            ((merged = merge(merged, get<members[Is]>(ops))), ...);
+            return merged;
+        }(std::make_index_sequence<members.size()>{});
     }
-} //namespace composed
-
-
-template <typename T>
-concept any_field_op = requires {
-    typename T::target_field_t;
-};
-
 
+    template <typename T>
+    constexpr uint64_t touched_mask_of()
+    {
+        if constexpr(requires { std::decay_t<T>::touched_mask(); }) return std::decay_t<T>::touched_mask();
+        else return ~uint64_t{0};
+    }
 
-template <typename T, auto pred>
-concept all_elements = requires(T&& v) {
-    { 
-        hof::fold(
-            v,
-            [](auto&& accum, auto&& item) { 
-                constexpr bool accum_value = std::decay_t<decltype(accum)>::value;
-                constexpr bool pred_value = std::decay_t<decltype(pred(item))>::value;
-                if constexpr(accum_value and pred_value) return std::true_type{};
-                else return std::false_type{};
-            },
-            std::true_type{}
-        ) 
-    } -> std::same_as<std::true_type>;
-};
-
-constexpr auto identity_test = [](auto&& item) { return std::decay_t<decltype(item)>{}; };
-static_assert(all_elements<tuple<std::true_type,std::true_type,std::true_type>,identity_test>);
-static_assert(not all_elements<tuple<std::true_type,std::false_type,std::true_type>,identity_test>);
-
-struct is_op_predicate {
-    constexpr std::false_type operator()(auto&&) { return {}; }
-    constexpr std::true_type operator()(any_op auto&&) { return {}; }
-};
+} //namespace composed
 
 template <typename T>
-concept any_composed_ops = utl::any_tuple<T> and 
-    all_elements<std::decay_t<decltype(composed::flatten(std::declval<T>()))>,is_op_predicate{}>;
+concept any_composed_ops = composed::any_composition<T> and 
+    composed::all_mergeable<composed::flattened_t<T>>::value;
 
 template <typename T>
-concept any_op_or_composition = any_op<T> or any_composed_ops<T>;
-
-
-constexpr auto tag_invoke(merge_t, any_field_op auto&&... ops)
-    requires same_target_register<decltype(ops)...>
-{
-    //all of the ops must have the same target register
-    //then, merge the masks.
-}
+concept any_op_or_composition = any_mergeable_op<T> or any_composed_ops<T>;
 
 constexpr auto compose(any_op_or_composition auto&&... ops)
 {
     return tuple{std::forward<decltype(ops)>(ops)...};
 }
 
-
-constexpr auto operator <=>(any_op auto const&, any_op auto const&)
-{
-    return std::partial_ordering::unordered;
-}
-constexpr auto operator ==(any_op auto const& a, any_op auto const& b)
-{
-    return (a <=> b) == std::partial_ordering::unordered;
-}
-
-
-//What is composable?
-//any operation targeting a single field
-//any composition of operations targeting a single field
-//types must have the same target register
-
-// template <typename... Ts>
-// concept composable = field::
-
-
-
-constexpr auto apply(auto&&... args)
-    requires ((any_op<decltype(args)> or any_composed_ops<decltype(args)>) and ...)
-{
-    any_tuple auto flattened = composed::flatten(utl::tuple{std::forward<decltype(args)>(args)...});
-    any_tuple auto sorted = composed::sort(flattened);
-    //sort
-    //split into contiguous chunks targeting the same register
-    //merge
-    //evaluate
-    //return an audit
-}
-
-
-
-
-
-
-
-
-
-
-template <typename T>
-struct bitwise_modify;
-
-template <any_register R>
-struct bitwise_modify_register {
-    using target_register_t = R;
-    using value_t = value_t<R>;
-    R target;
-    value_t set_mask;
-    value_t clear_mask;
-
-    friend constexpr auto tag_invoke(evaluate_t, R r, value_t v, bitwise_modify_register a)
+namespace detail {
+    constexpr size_t highest_bit(uint64_t v)
     {
-        write(r, (v | a.set_mask) & (~a.clear_mask));
+        size_t bit = 0;
+        while((v >>= 1) != 0) bit++;
+        return bit;
     }
 
-    friend constexpr auto tag_invoke(merge_t, bitwise_modify_register a, bitwise_modify_register b)
+    constexpr bool single_bit(uint64_t v)
     {
-        return bitwise_modify_register{
-            b.target,
-            (a.set_mask | b.set_mask) & ~b.clear_mask,
-            (a.clear_mask | b.clear_mask) & ~ b.set_mask
-        };
+        return v != 0 and (v & (v - 1)) == 0;
     }
-};
 
-template <field::any_field T>
-struct bitwise_modify_field {
-    using target_field_t = T;
-    using target_register_t = field::register_t<T>;
-    using value_t = field::value_t<T>;
-    T target;
-    value_t set_mask;
-    value_t clear_mask;
-
-    friend constexpr auto tag_invoke(evaluate_t, target_register_t r, field::register_value_t<T> v, bitwise_modify_field a)
+    template <any_register R, uint64_t Touched>
+    constexpr bool fits_set_clear_register()
     {
-        const auto set = field::align_to_register(a.target, a.set_mask);
-        const auto clear = field::align_to_register(a.target, a.clear_mask);
-        write(r, (v | set) & (~clear));
+        if constexpr(has_set_clear_register<R>) {
+            using alias_t = typename R::set_clear_t;
+            constexpr size_t offset = alias_t::clear_offset();
+            return (Touched >> offset) == 0
+                and highest_bit(Touched) + offset < registers::width<alias_t>();
+        } else {
+            return false;
+        }
     }
 
-    friend constexpr auto tag_invoke(merge_t, bitwise_modify_field a, bitwise_modify_register<target_register_t> b)
+    template <typename T>
+    constexpr auto as_value_of(auto v)
     {
-        return bitwise_modify_register<target_register_t>{
-            b.target,
-            (field::align_to_register(a.target, a.set_mask) | b.set_mask) & ~b.clear_mask,
-            (field::align_to_register(a.target, a.clear_mask) | b.clear_mask) & ~ b.set_mask
-        };
+        return static_cast<registers::value_t<T>>(v);
     }
 
-    friend constexpr auto tag_invoke(merge_t, bitwise_modify_register<target_register_t> a, bitwise_modify_field b)
+    template <any_register R>
+    void read_modify_write(bitwise_modify_register<R> merged)
     {
-        const auto b_set = field::align_to_register(b.target, b.set_mask);
-        const auto b_clear = field::align_to_register(b.target, b.clear_mask);
-        return bitwise_modify_register{
-            b.target,
-            (a.set_mask | b_set) & ~b_clear,
-            (a.clear_mask | b_clear) & ~ b_set
-        };
+        write(merged.target, evaluate(merged.target, read(merged.target), merged));
     }
 
-    // friend constexpr auto tag_invoke(merge_t, bitwise_modify<T> a, bitwise_modify<T> b)
-    // {
-    //     return bitwise_modify<register_t>{
-    //         b.target,
-    //         (field::align_to_register(a.target, a.set_mask) | b.set_mask) & ~b.clear_mask,
-    //         (field::align_to_register(a.target, a.clear_mask) | b.clear_mask) & ~ b.set_mask
-    //     };
-    // }
-};
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
-
+    //True if the set and clear masks both reach into one of the
+    //multi-bit fields. Storing the set bits and then the clear bits
+    //would briefly leave such a field holding neither its old value
+    //nor its new one (01 -> 11 -> 10).
+    template <uint64_t... Fields>
+    constexpr bool splits_a_field(uint64_t set, uint64_t clear)
+    {
+        return ((not single_bit(Fields) and (set & Fields) != 0 and (clear & Fields) != 0) or ...);
+    }
 
+    //Performs a merged op whose ops touch the fields whose masks are
+    //Fields. Where a register has a write-only set/clear alias or
+    //per-bit aliases, the update is a single store with no read.
+    //Separate set and clear registers take two stores, so they're only
+    //used when no multi-bit field is both set and cleared; otherwise,
+    //as for everything else, the register gets one read and one write.
+    template <uint64_t... Fields, any_register R>
+    void commit(bitwise_modify_register<R> merged)
+    {
+        constexpr uint64_t touched = (Fields | ...);
+        if constexpr(fits_set_clear_register<R,touched>()) {
+            using alias_t = typename R::set_clear_t;
+            const auto set = as_value_of<alias_t>(merged.set_mask);
+            const auto clear = as_value_of<alias_t>(as_value_of<alias_t>(merged.clear_mask) << alias_t::clear_offset());
+            write(alias_t{}, as_value_of<alias_t>(set | clear));
+        } else if constexpr(has_bit_aliases<R> and single_bit(touched)) {
+            constexpr size_t bit = highest_bit(touched);
+            using alias_t = typename R::template bit_alias_t<bit>;
+            if((((merged.set_mask | merged.clear_mask) >> bit) & 1) != 0) {
+                write(alias_t{}, as_value_of<alias_t>((merged.set_mask >> bit) & 1));
+            }
+        } else if constexpr(has_set_and_clear_registers<R>) {
+            //the two stores are the only way to update a write-only register
+            if constexpr(any_readable_register<R>) {
+                if(splits_a_field<Fields...>(merged.set_mask, merged.clear_mask)) {
+                    read_modify_write(merged);
+                    return;
+                }
+            }
+            if(merged.set_mask != 0) write(typename R::set_t{}, as_value_of<typename R::set_t>(merged.set_mask));
+            if(merged.clear_mask != 0) write(typename R::clear_t{}, as_value_of<typename R::clear_t>(merged.clear_mask));
+        } else {
+            read_modify_write(merged);
+        }
+    }
 
+    //Merges the ops in group G and commits them.
+    template <size_t G, typename Ops>
+    void commit_group(Ops const& ops)
+    {
+        using groups_t = composed::groups_of_t<Ops>;
+        constexpr auto& members = groups_t::template members<G>;
+        [&]<size_t... Is>(std::index_sequence<Is...>) {
+            commit<composed::touched_mask_of<tuple_element_t<members[Is],std::decay_t<Ops>>>()...>(
+                composed::merge_group<G>(ops));
+        }(std::make_index_sequence<members.size()>{});
+    }
+} //namespace detail
+
+//Merges the ops (and compositions of ops) given to it, then updates
+//each register they touch once, in the order the registers are first
+//mentioned: with a single read and write, or, where the register has
+//set/clear aliases, with write-only stores. Returns nothing; an update
+//through aliases never learns the register's new value, so read the
+//register if it's needed.
+void apply(any_op_or_composition auto&&... args)
+    requires (sizeof...(args) > 0)
+{
+    const auto flattened = composed::flatten(tuple{std::forward<decltype(args)>(args)...});
+    using groups_t = composed::groups_of_t<decltype(flattened)>;
 
+    [&]<size_t... Gs>(std::index_sequence<Gs...>) {
+        (detail::commit_group<Gs>(flattened), ...);
+    }(std::make_index_sequence<groups_t::n_groups>{});
+}
 
 
 // okay. so I've been struggling a bit with how composable field operations should be.
@@ -442,12 +398,14 @@ struct bitwise_modify_field {
 // for local ordering, it's left-to-right.
 // for nonlocal ordering, it's a user defined spaceship operator.
 // then, a composition is ordered before it is evaluated.
+//
+// apply() implements the first scenario: registers are committed in
+// the order they're first mentioned and ops on the same register are
+// merged left-to-right, later ops winning.
 
 
 
 // ultimately, a driver is a generated composition of register
 // operations? does that make sense? 
 
-
-
-}
+} //namespace utl::registers::ops
@@ -8,6 +8,7 @@
 #pragma once
 
 #include <stddef.h>
+#include <stdint.h>
 #include <utility>
 #include <bfg/tag_invoke.h>
 #include <utl/integer.hh>
@@ -49,13 +50,13 @@ template <typename T>
 concept any_register = has_width<T> and has_reset_value<T>;
 
 template <typename T>
-using value_t = std::decay_t<decltype(reset_value(declval<T>()))>;
+using value_t = std::decay_t<decltype(std::decay_t<T>::reset_value())>;
 
 template <typename T, typename R>
 concept same_register_as = std::same_as<std::decay_t<R>, std::decay_t<T>>;
 
-template <typename... Ts>
-concept same_target_register = ((any_register<Ts> and same_register_as<tuple_element_t<0,tuple<Ts...>>,Ts>) and ...);
+template <typename T, typename... Ts>
+concept same_target_register = any_register<T> and (same_register_as<T,Ts> and ...);
 
 template <typename T>
 concept any_readable_register = any_register<T> and
@@ -66,7 +67,53 @@ concept any_readable_register = any_register<T> and
 
 template <typename T>
 concept any_writable_register = any_register<T> and
-    requires(T r, utl::integer::unsigned_cast_t<T> v) {
+    requires(T r, value_t<T> v) {
         { write(r,v) } -> std::same_as<void>;
     };
+
+//Registers can advertise write-only aliases that change bits without
+//a read-modify-write. The op layer uses them when it can.
+
+//A single alias where writing 1 to bit n sets it and writing 1 to bit
+//n + clear_offset() clears it, like STM32's GPIOx_BSRR:
+//  using set_clear_t = gpioa_bsrr; //gpioa_bsrr::clear_offset() == 16
+template <typename T>
+concept has_set_clear_register = any_register<T> and requires {
+    typename std::decay_t<T>::set_clear_t;
+    { std::decay_t<T>::set_clear_t::clear_offset() } -> std::convertible_to<size_t>;
+} and any_writable_register<typename std::decay_t<T>::set_clear_t>;
+
+//Separate aliases where writing 1 to a bit sets or clears it:
+//  using set_t = outset;
+//  using clear_t = outclr;
+template <typename T>
+concept has_set_and_clear_registers = any_register<T> and requires {
+    typename std::decay_t<T>::set_t;
+    typename std::decay_t<T>::clear_t;
+} and any_writable_register<typename std::decay_t<T>::set_t>
+  and any_writable_register<typename std::decay_t<T>::clear_t>;
+
+//One alias per bit; writing 1 or 0 to it sets or clears that bit,
+//like Cortex-M3/M4 bit-banding:
+//  template <size_t Bit> using bit_alias_t = ...;
+template <typename T>
+concept has_bit_aliases = any_register<T> and requires {
+    typename std::decay_t<T>::template bit_alias_t<0>;
+} and any_writable_register<typename std::decay_t<T>::template bit_alias_t<0>>;
+
+//Address of the bit-band alias word for a bit of a register in the
+//Cortex-M3/M4 SRAM or peripheral bit-band regions.
+constexpr uintptr_t bit_band_alias(uintptr_t address, size_t bit)
+{
+    constexpr uintptr_t region_mask = 0xF000'0000;
+    constexpr uintptr_t offset_mask = 0x000F'FFFF;
+    constexpr uintptr_t alias_offset = 0x0200'0000;
+    constexpr uintptr_t bytes_per_bit = 4;
+    constexpr uintptr_t bits_per_byte = 8;
+    return (address & region_mask) + alias_offset 
+        + (address & offset_mask) * bits_per_byte * bytes_per_bit 
+        + bit * bytes_per_bit;
+}
+
+static_assert(bit_band_alias(0x4001'080C, 5) == 0x4221'0194);
 } //namespace utl::registers
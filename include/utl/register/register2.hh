@@ -5,3 +5,55 @@
 // 
 //     http://www.apache.org/licenses/LICENSE-2.0
 
+#pragma once
+
+#include <utl/register/register.hh>
+
+namespace utl::registers {
+
+//Wraps a register whose hardware value can't be read back: write-only
+//registers, or ones where a read has side effects. The library keeps
+//a RAM shadow of the last value written, seeded from reset_value().
+//Reads return the shadow without touching the bus, so a field op on
+//a shadowed register costs a single store.
+//
+//The shadow is only correct if every write goes through the wrapper.
+//Like any read-modify-write, updating it from both thread and ISR
+//context needs a critical section.
+template <any_writable_register R>
+struct shadowed {
+    using register_t = R;
+    using value_type = value_t<R>;
+
+    static constexpr size_t width() { return registers::width<R>(); }
+    static constexpr value_type reset_value() { return R::reset_value(); }
+
+    //e.g. after the peripheral has been reset
+    static void reset() { shadow = reset_value(); }
+    [[nodiscard]] static value_type peek() { return shadow; }
+
+    friend value_type tag_invoke(read_t, shadowed)
+    {
+        return shadow;
+    }
+
+    friend void tag_invoke(write_t, shadowed, value_type v)
+    {
+        shadow = v;
+        write(R{}, v);
+    }
+
+private:
+    static inline value_type shadow = R::reset_value(); //NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+};
+
+template <typename T>
+struct is_shadowed : std::false_type {};
+
+template <typename R>
+struct is_shadowed<shadowed<R>> : std::true_type {};
+
+template <typename T>
+concept any_shadowed_register = is_shadowed<std::decay_t<T>>::value;
+
+} //namespace utl::registers
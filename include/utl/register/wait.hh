@@ -0,0 +1,163 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <concepts>
+#include <type_traits>
+#include <utl/result.hh>
+#include <utl/register/register.hh>
+#include <utl/register/field.hh>
+
+namespace utl::registers {
+
+//Spin statistics for one polling site. Keep one per call site
+//(e.g. a function-local static) and pass it to wait_until.
+struct spin_statistics {
+    uint32_t calls = 0;
+    uint32_t timeouts = 0;
+    uint64_t total = 0;   //iterations or ticks, matching the budget
+    uint64_t longest = 0;
+
+    constexpr void record(uint64_t elapsed, bool timed_out)
+    {
+        calls++;
+        if(timed_out) timeouts++;
+        total += elapsed;
+        if(elapsed > longest) longest = elapsed;
+    }
+
+    [[nodiscard]] constexpr uint64_t mean() const
+    {
+        return calls == 0 ? 0 : total / calls;
+    }
+};
+
+//Backoff hooks are called with the number of failed polls so far,
+//after each poll that didn't satisfy the predicate.
+struct no_backoff {
+    constexpr void operator()(size_t) const {}
+};
+
+//Busy-waits for twice as long after each failed poll, up to a limit,
+//so a slow peripheral isn't hammered with bus reads.
+struct spin_backoff {
+    size_t limit;
+
+    void operator()(size_t attempt) const
+    {
+        constexpr size_t max_shift = 16;
+        const size_t shift = attempt < max_shift ? attempt : max_shift;
+        const size_t delay = (size_t{1} << shift) < limit ? (size_t{1} << shift) : limit;
+        for(size_t idx = 0; idx < delay; idx++) {
+            asm volatile("" ::: "memory");
+        }
+    }
+};
+
+#if defined(__ARM_ARCH)
+//Sleeps until the next event. Only useful when the peripheral (or its
+//interrupt) generates one when the awaited condition becomes true.
+struct wait_for_event {
+    void operator()(size_t) const { asm volatile("wfe"); }
+};
+#endif
+
+//A budget of clock ticks rather than polls. The clock is any callable
+//returning an unsigned counter that wraps (e.g. DWT->CYCCNT).
+template <typename Clock>
+struct tick_budget {
+    Clock clock;
+    std::invoke_result_t<Clock&> ticks;
+};
+
+template <typename Clock, typename T>
+tick_budget(Clock, T) -> tick_budget<Clock>;
+
+namespace detail {
+    struct poll_counter {
+        size_t limit;
+        size_t polls = 0;
+
+        constexpr void advance() { polls++; }
+        [[nodiscard]] constexpr bool expired() const { return polls >= limit; }
+        [[nodiscard]] constexpr size_t elapsed() const { return polls; }
+    };
+
+    template <typename Clock>
+    struct tick_counter {
+        using ticks_t = std::invoke_result_t<Clock&>;
+        //A copy, since a budget is only a clock and a tick count and the
+        //caller's may be const. Mutable so the const queries can call a
+        //stateful clock.
+        mutable tick_budget<Clock> budget;
+        ticks_t start = budget.clock();
+
+        constexpr void advance() {}
+        [[nodiscard]] constexpr bool expired() const { return elapsed() >= budget.ticks; }
+        [[nodiscard]] constexpr ticks_t elapsed() const
+        {
+            return static_cast<ticks_t>(budget.clock() - start);
+        }
+    };
+
+    constexpr auto make_counter(size_t polls) { return poll_counter{polls}; }
+
+    template <typename Clock>
+    constexpr auto make_counter(tick_budget<Clock> const& budget) { return tick_counter<Clock>{budget}; }
+
+    template <field::any_field F>
+    auto wait_until(F f, auto&& predicate, auto&& budget, auto&& backoff, spin_statistics* stats)
+        -> result<decltype(make_counter(budget).elapsed())>
+    {
+        using register_t = field::register_t<F>;
+        auto counter = make_counter(budget);
+        size_t attempt = 0;
+        while(true) {
+            const auto value = field::align_from_register(f, read(register_t{}));
+            counter.advance();
+            if(predicate(value)) {
+                const auto elapsed = counter.elapsed();
+                if(stats != nullptr) stats->record(static_cast<uint64_t>(elapsed), false);
+                return elapsed;
+            }
+            if(counter.expired()) {
+                if(stats != nullptr) stats->record(static_cast<uint64_t>(counter.elapsed()), true);
+                return errc::timeout;
+            }
+            backoff(attempt++);
+        }
+    }
+} //namespace detail
+
+template <typename T>
+concept any_wait_budget = std::convertible_to<T,size_t> or requires(T b) {
+    { b.clock() } -> std::unsigned_integral;
+    b.ticks;
+};
+
+//Polls a field until predicate(value) holds. The budget is either a
+//number of polls or a tick_budget. Returns the polls or ticks it took,
+//or errc::timeout once the budget is spent. The field is always read
+//at least once, even with an empty budget.
+template <field::any_field F, typename P, any_wait_budget B, typename H = no_backoff>
+    requires std::predicate<P&, field::value_t<F>> and std::invocable<H&, size_t>
+auto wait_until(F f, P&& predicate, B&& budget, H&& backoff = {})
+{
+    return detail::wait_until(f, predicate, budget, backoff, nullptr);
+}
+
+template <field::any_field F, typename P, any_wait_budget B, typename H>
+    requires std::predicate<P&, field::value_t<F>> and std::invocable<H&, size_t>
+auto wait_until(F f, P&& predicate, B&& budget, H&& backoff, spin_statistics& stats)
+{
+    return detail::wait_until(f, predicate, budget, backoff, &stats);
+}
+
+} //namespace utl::registers
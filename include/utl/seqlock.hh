@@ -0,0 +1,177 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <atomic>
+#include <concepts>
+#include <type_traits>
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/result.hh>
+
+namespace utl {
+
+//Snapshots are copied word by word, so anything that can be
+//memcpy'd is fair game regardless of its size.
+template <typename T>
+concept any_snapshot = std::is_trivially_copyable_v<T>
+    and std::is_default_constructible_v<T>;
+
+//A sequence lock for a single writer (typically an ISR) and any
+//number of readers. The writer never waits; a reader that overlaps
+//with a write sees the sequence number change and tries again.
+//
+//The payload is stored as an array of relaxed atomic words rather
+//than as a T. A torn read is then a detectable retry instead of a
+//data race, and on Cortex-M every one of those accesses is a plain
+//LDR/STR.
+template <any_snapshot T>
+class seqlock {
+    using word_t = uintptr_t;
+    static constexpr size_t n_words = (sizeof(T) + sizeof(word_t) - 1) / sizeof(word_t);
+    using buffer_t = utl::array<word_t,n_words>;
+
+    static_assert(std::atomic<word_t>::is_always_lock_free,
+        "seqlock requires lock-free word-sized atomics");
+    static_assert(std::atomic<uint32_t>::is_always_lock_free,
+        "seqlock requires a lock-free sequence counter");
+
+    std::atomic<uint32_t> m_sequence{0};
+    utl::array<std::atomic<word_t>,n_words> m_words{};
+
+    [[nodiscard]] bool try_read_into(T& out) const
+    {
+        const auto before = m_sequence.load(std::memory_order_acquire);
+        if((before & 1u) != 0) return false; //write in progress
+
+        buffer_t buffer{};
+        for(size_t idx = 0; idx < n_words; idx++) {
+            buffer[idx] = m_words[idx].load(std::memory_order_relaxed);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const auto after = m_sequence.load(std::memory_order_relaxed);
+        if(before != after) return false; //torn
+
+        __builtin_memcpy(&out, buffer.data(), sizeof(T));
+        return true;
+    }
+
+public:
+    using value_t = T;
+
+    constexpr seqlock() = default;
+    explicit seqlock(T const& initial) { write(initial); }
+
+    seqlock(seqlock const&) = delete;
+    seqlock& operator=(seqlock const&) = delete;
+    seqlock(seqlock&&) = delete;
+    seqlock& operator=(seqlock&&) = delete;
+    ~seqlock() = default;
+
+    //Must only ever be called from one context. The sequence number
+    //is updated with plain stores rather than read-modify-writes,
+    //which keeps this usable on cores without LDREX/STREX.
+    void write(T const& value)
+    {
+        buffer_t buffer{};
+        __builtin_memcpy(buffer.data(), &value, sizeof(T));
+
+        const auto sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for(size_t idx = 0; idx < n_words; idx++) {
+            m_words[idx].store(buffer[idx], std::memory_order_relaxed);
+        }
+
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    //A single attempt. Fails with errc::busy if a write overlapped.
+    //Readers that can preempt the writer (e.g. a higher priority ISR)
+    //must use this; spinning in read() would never complete.
+    [[nodiscard]] result<T> try_read() const
+    {
+        T value{};
+        if(not try_read_into(value)) return errc::busy;
+        return value;
+    }
+
+    [[nodiscard]] T read() const
+    {
+        T value{};
+        while(not try_read_into(value)) {}
+        return value;
+    }
+
+    //Number of completed writes.
+    [[nodiscard]] uint32_t version() const
+    {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+};
+
+//A triple buffer for a single writer and a single reader. Neither
+//side ever retries or waits: the writer fills a private back buffer
+//and swaps it with the shared middle buffer, and the reader swaps
+//the middle buffer for its front buffer only when a newer snapshot
+//has been published.
+//
+//The swap is an atomic exchange, so unlike seqlock this needs
+//read-modify-write atomics (i.e. not Cortex-M0).
+template <any_snapshot T>
+class triple_buffer {
+    static constexpr uint8_t index_mask = 0x3;
+    static constexpr uint8_t dirty = 0x4;
+
+    static_assert(std::atomic<uint8_t>::is_always_lock_free,
+        "triple_buffer requires lock-free byte-sized atomics");
+
+    utl::array<T,3> m_buffers{};
+    std::atomic<uint8_t> m_middle{1};
+    uint8_t m_back{0};  //owned by the writer
+    uint8_t m_front{2}; //owned by the reader
+
+public:
+    using value_t = T;
+
+    constexpr triple_buffer() = default;
+
+    triple_buffer(triple_buffer const&) = delete;
+    triple_buffer& operator=(triple_buffer const&) = delete;
+    triple_buffer(triple_buffer&&) = delete;
+    triple_buffer& operator=(triple_buffer&&) = delete;
+    ~triple_buffer() = default;
+
+    void write(T const& value)
+    {
+        m_buffers[m_back] = value;
+        const auto previous = m_middle.exchange(
+            static_cast<uint8_t>(m_back | dirty), std::memory_order_acq_rel);
+        m_back = previous & index_mask;
+    }
+
+    [[nodiscard]] bool has_update() const
+    {
+        return (m_middle.load(std::memory_order_relaxed) & dirty) != 0;
+    }
+
+    //The returned reference is stable until the next call to read().
+    [[nodiscard]] T const& read()
+    {
+        if(has_update()) {
+            const auto previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+            m_front = previous & index_mask;
+        }
+        return m_buffers[m_front];
+    }
+};
+
+} //namespace utl
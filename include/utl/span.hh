@@ -7,6 +7,8 @@
 
 #pragma once
 #include <utl/array.hh>
+#include <concepts>
+#include <type_traits>
 
 namespace utl {
 
@@ -34,6 +36,14 @@ public:
     template <size_t N>
     constexpr span(array<T,N> const& arr) : m_container{arr.data()}, m_size{N} {}
 
+    //a span of const elements can view a mutable container
+    template <size_t N>
+        requires std::is_const_v<T>
+    constexpr span(array<std::remove_const_t<T>,N> const& arr) : m_container{arr.data()}, m_size{N} {}
+    template <typename U>
+        requires (std::is_const_v<T> and std::same_as<U,std::remove_const_t<T>>)
+    constexpr span(span<U> const& other) : m_container{other.data()}, m_size{other.size()} {}
+
     constexpr T& operator[](size_t index) const
     {
         return access(index);
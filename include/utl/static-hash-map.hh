@@ -0,0 +1,262 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <bit>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+#include <utl/utl.hh>
+#include <utl/error.hh>
+#include <utl/result.hh>
+#include <utl/array.hh>
+#include <utl/hash.hh>
+#include <utl/tuple.hh>
+#include <utl/bits/fixed_map.hh>
+
+namespace utl {
+
+//A hash map with room for N entries, in a fixed table with no
+//allocation. Keys are hashed with H (utl::hash<K> by default) and
+//placed by open addressing with linear probing, using Robin Hood
+//displacement: an entry being inserted takes the slot of any entry
+//that's closer to its own home slot, so no entry ends up far from
+//home, and a lookup for a missing key stops as soon as it reaches an
+//entry closer to home than it would be.
+//
+//Erasing shifts the entries after the erased one back a slot, until
+//one that's at home or an empty slot, so there are no tombstones: the
+//table doesn't fill up with deleted entries under churn, and lookups
+//never get slower for having erased.
+//
+//The table has a power of two slots, with at least a fifth of them
+//empty when the map is full. Empty slots hold default constructed keys
+//and values, and displacement moves entries between slots by
+//assignment, so K and V must be default constructible and assignable.
+template <typename K, typename V, size_t N, typename H = utl::hash<K>>
+class static_hash_map {
+    static_assert(N > 0, "static_hash_map must have room for at least one entry");
+
+    static constexpr size_t n_slots = std::bit_ceil(N + N / 4 + 1);
+    static constexpr size_t mask = n_slots - 1;
+
+    //A slot's distance from its key's home slot, plus one; zero is
+    //empty. No entry is ever more than N slots from home.
+    using distance_t = std::conditional_t<(N < 0xFF), uint8_t, uint16_t>;
+
+    utl::array<K,n_slots> m_keys{};
+    utl::array<V,n_slots> m_values{};
+    utl::array<distance_t,n_slots> m_distances{};
+    size_t m_size = 0;
+
+    [[nodiscard]] static constexpr size_t home(K const& key)
+    {
+        return H{}(key) & mask;
+    }
+
+    [[nodiscard]] constexpr size_t index_of(K const& key) const
+    {
+        size_t index = home(key);
+        for(distance_t distance = 1;; distance++) {
+            //an entry closer to home than the key would be is where
+            //the key would have displaced it
+            if(m_distances[index] < distance) return npos;
+            if(m_distances[index] == distance and m_keys[index] == key) return index;
+            index = (index + 1) & mask;
+        }
+    }
+
+    //Requires that key isn't in the map, and the map isn't full.
+    //Returns the slot key ends up in.
+    template <typename T>
+    constexpr size_t place(K key, T&& value)
+    {
+        V carried = std::forward<T>(value);
+        size_t index = home(key);
+        size_t placed = npos;
+        for(distance_t distance = 1;; distance++) {
+            if(m_distances[index] == 0) {
+                m_keys[index] = std::move(key);
+                m_values[index] = std::move(carried);
+                m_distances[index] = distance;
+                m_size++;
+                return placed == npos ? index : placed;
+            }
+            if(m_distances[index] < distance) {
+                //take the slot, and carry on placing its entry instead
+                std::swap(key, m_keys[index]);
+                std::swap(carried, m_values[index]);
+                std::swap(distance, m_distances[index]);
+                if(placed == npos) placed = index;
+            }
+            index = (index + 1) & mask;
+        }
+    }
+
+    constexpr void remove(size_t index)
+    {
+        size_t next = (index + 1) & mask;
+        while(m_distances[next] > 1) {
+            m_keys[index] = std::move(m_keys[next]);
+            m_values[index] = std::move(m_values[next]);
+            m_distances[index] = static_cast<distance_t>(m_distances[next] - 1);
+            index = next;
+            next = (next + 1) & mask;
+        }
+        m_keys[index] = K{};
+        m_values[index] = V{};
+        m_distances[index] = 0;
+        m_size--;
+    }
+
+    template <typename M, typename T>
+    class basic_iterator {
+        M* m_map;
+        size_t m_index;
+
+        constexpr void skip_empty()
+        {
+            while(m_index < n_slots and m_map->m_distances[m_index] == 0) m_index++;
+        }
+
+    public:
+        constexpr basic_iterator(M* map, size_t index) : m_map{map}, m_index{index} { skip_empty(); }
+
+        constexpr auto operator*() const
+        {
+            return utl::tuple<K const&,T&>{m_map->m_keys[m_index], m_map->m_values[m_index]};
+        }
+
+        constexpr basic_iterator& operator++()
+        {
+            m_index++;
+            skip_empty();
+            return *this;
+        }
+
+        constexpr basic_iterator operator++(int)
+        {
+            auto previous = *this;
+            operator++();
+            return previous;
+        }
+
+        constexpr bool operator==(basic_iterator const& other) const { return m_index == other.m_index; }
+    };
+
+public:
+    using key_t = K;
+    using value_t = V;
+    using iterator = basic_iterator<static_hash_map,V>;
+    using const_iterator = basic_iterator<const static_hash_map,const V>;
+
+    struct entry {
+        K key;
+        V value;
+    };
+
+    constexpr static_hash_map() = default;
+
+    //Places each entry as insert_or_assign would, so a repeated key
+    //takes one slot and the value given last. A constexpr map with
+    //more distinct keys than N doesn't compile; at runtime the keys
+    //that don't fit are dropped.
+    constexpr static_hash_map(std::initializer_list<entry> entries)
+    {
+        for(auto const& item : entries) {
+            const size_t index = index_of(item.key);
+            if(index != npos) {
+                m_values[index] = item.value;
+            } else if(not full()) {
+                place(item.key, item.value);
+            } else if(std::is_constant_evaluated()) {
+                detail::fixed_map_too_many_entries();
+            }
+        }
+    }
+
+    static constexpr size_t capacity() { return N; }
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+    [[nodiscard]] constexpr bool full() const { return m_size == N; }
+
+    //The value for key, or nullptr if there isn't one.
+    [[nodiscard]] constexpr V* find(K const& key)
+    {
+        const size_t index = index_of(key);
+        return index == npos ? nullptr : &m_values[index];
+    }
+
+    [[nodiscard]] constexpr V const* find(K const& key) const
+    {
+        const size_t index = index_of(key);
+        return index == npos ? nullptr : &m_values[index];
+    }
+
+    [[nodiscard]] constexpr bool contains(K const& key) const
+    {
+        return index_of(key) != npos;
+    }
+
+    //Places a new key, displacing entries further along its probe
+    //sequence as needed, and returns its value. A key that's already
+    //present keeps its value, which is returned instead. Returns
+    //errc::out_of_bounds if key is new and the map is full.
+    template <typename T = V>
+    constexpr result<V&> insert(K const& key, T&& value)
+    {
+        const size_t index = index_of(key);
+        if(index != npos) return success<V&>(m_values[index]);
+        if(full()) return errc::out_of_bounds;
+        return success<V&>(m_values[place(key, std::forward<T>(value))]);
+    }
+
+    //Like insert, but overwrites the value of a key that's already
+    //in the map.
+    template <typename T = V>
+    constexpr result<V&> insert_or_assign(K const& key, T&& value)
+    {
+        const size_t index = index_of(key);
+        if(index != npos) {
+            m_values[index] = std::forward<T>(value);
+            return success<V&>(m_values[index]);
+        }
+        if(full()) return errc::out_of_bounds;
+        return success<V&>(m_values[place(key, std::forward<T>(value))]);
+    }
+
+    //Returns false if key wasn't in the map.
+    constexpr bool erase(K const& key)
+    {
+        const size_t index = index_of(key);
+        if(index == npos) return false;
+        remove(index);
+        return true;
+    }
+
+    constexpr void clear()
+    {
+        for(size_t idx = 0; idx < n_slots; idx++) {
+            if(m_distances[idx] == 0) continue;
+            m_keys[idx] = K{};
+            m_values[idx] = V{};
+            m_distances[idx] = 0;
+        }
+        m_size = 0;
+    }
+
+    //Iterating gives a utl::tuple of the key and a reference to its
+    //value, in no particular order.
+    [[nodiscard]] constexpr iterator begin() { return {this, 0}; }
+    [[nodiscard]] constexpr const_iterator begin() const { return {this, 0}; }
+    [[nodiscard]] constexpr iterator end() { return {this, n_slots}; }
+    [[nodiscard]] constexpr const_iterator end() const { return {this, n_slots}; }
+};
+
+} //namespace utl
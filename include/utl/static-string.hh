@@ -0,0 +1,223 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utl/utl.hh>
+#include <utl/string-view.hh>
+
+namespace utl {
+
+//A string with room for N characters that keeps track of its own
+//length, so length() is constant time and appending doesn't rescan
+//what's already there. Use it for building messages a piece at a
+//time; string<N> is fine for text that's written once.
+//
+//The contents are always null terminated. Anything appended beyond
+//the capacity is dropped, and the string remembers that it was
+//truncated.
+template <size_t N, typename char_t = char>
+class static_string {
+    char_t m_elements[N+1]{}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    size_t m_length = 0;
+    bool m_truncated = false;
+
+    [[nodiscard]] constexpr char_t& access(size_t index)
+    {
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index)
+        return m_elements[index];
+    }
+
+    [[nodiscard]] constexpr char_t const& access(size_t index) const
+    {
+        //NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic,cppcoreguidelines-pro-bounds-constant-array-index)
+        return m_elements[index];
+    }
+
+    constexpr void copy_in(size_t pos, const char_t* str, size_t count)
+    {
+        if(count == 0) return;
+        if(std::is_constant_evaluated()) {
+            for(size_t idx = 0; idx < count; idx++) access(pos + idx) = str[idx]; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        } else {
+            __builtin_memcpy(&access(pos), str, count * sizeof(char_t));
+        }
+    }
+
+public:
+    constexpr static_string() = default;
+
+    constexpr static_string(const char_t* str) //NOLINT(google-explicit-constructor)
+    {
+        append(str);
+    }
+
+    explicit constexpr static_string(string_view view)
+    {
+        append(view);
+    }
+
+    constexpr static_string(size_t count, char_t ch)
+    {
+        resize(count, ch);
+    }
+
+    static constexpr size_t capacity() { return N; }
+
+    [[nodiscard]] constexpr size_t length() const { return m_length; }
+    [[nodiscard]] constexpr size_t size() const { return m_length; }
+    [[nodiscard]] constexpr size_t available() const { return N - m_length; }
+    [[nodiscard]] constexpr bool empty() const { return m_length == 0; }
+    [[nodiscard]] constexpr bool full() const { return m_length == N; }
+
+    //True if anything has been dropped since the string was last
+    //cleared.
+    [[nodiscard]] constexpr bool truncated() const { return m_truncated; }
+
+    [[nodiscard]] constexpr const char_t* data() const { return &access(0); }
+    [[nodiscard]] constexpr const char_t* c_str() const { return data(); }
+
+    constexpr char_t& operator[](size_t idx) { return access(idx); }
+    constexpr char_t const& operator[](size_t idx) const { return access(idx); }
+
+    constexpr char_t* begin() { return &access(0); }
+    [[nodiscard]] constexpr const char_t* begin() const { return &access(0); }
+    constexpr char_t* end() { return &access(m_length); }
+    [[nodiscard]] constexpr const char_t* end() const { return &access(m_length); }
+
+    constexpr operator string_view() const //NOLINT(google-explicit-constructor)
+    {
+        return {data(), m_length};
+    }
+
+    [[nodiscard]] constexpr size_t find(string_view v, size_t pos = 0) const
+    {
+        return search::find(data(), m_length, v.data(), v.length(), pos);
+    }
+
+    [[nodiscard]] constexpr size_t rfind(string_view v, size_t pos = npos) const
+    {
+        return search::rfind(data(), m_length, v.data(), v.length(), pos);
+    }
+
+    constexpr void clear()
+    {
+        m_length = 0;
+        m_truncated = false;
+        access(0) = '\0';
+    }
+
+    //Returns false, and drops the character, if the string is full.
+    constexpr bool push_back(char_t ch)
+    {
+        if(m_length == N) {
+            m_truncated = true;
+            return false;
+        }
+        access(m_length++) = ch;
+        access(m_length) = '\0';
+        return true;
+    }
+
+    constexpr void pop_back()
+    {
+        if(m_length > 0) access(--m_length) = '\0';
+    }
+
+    //Appends as much of view as fits. Returns the number of
+    //characters appended.
+    constexpr size_t append(string_view view)
+    {
+        size_t count = view.size();
+        if(count > available()) {
+            count = available();
+            m_truncated = true;
+        }
+        copy_in(m_length, view.data(), count);
+        m_length += count;
+        access(m_length) = '\0';
+        return count;
+    }
+
+    constexpr size_t append(const char_t* str)
+    {
+        return append(string_view{str});
+    }
+
+    constexpr size_t append(size_t count, char_t ch)
+    {
+        if(count > available()) {
+            count = available();
+            m_truncated = true;
+        }
+        for(size_t idx = 0; idx < count; idx++) access(m_length + idx) = ch;
+        m_length += count;
+        access(m_length) = '\0';
+        return count;
+    }
+
+    //Shortens the string, or pads it with ch, to count characters
+    //(or N, if that's smaller).
+    constexpr void resize(size_t count, char_t ch = '\0')
+    {
+        if(count > m_length) {
+            append(count - m_length, ch);
+        } else {
+            m_length = count;
+            access(m_length) = '\0';
+        }
+    }
+
+    constexpr static_string& operator+=(string_view view)
+    {
+        append(view);
+        return *this;
+    }
+
+    constexpr static_string& operator+=(const char_t* str)
+    {
+        append(str);
+        return *this;
+    }
+
+    constexpr static_string& operator+=(char_t ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    template <size_t M>
+    [[nodiscard]] constexpr auto operator+(static_string<M,char_t> const& other) const
+    {
+        static_string<N+M,char_t> result{*this};
+        result.append(other);
+        return result;
+    }
+
+    template <size_t M>
+    constexpr bool operator==(static_string<M,char_t> const& other) const
+    {
+        return string_view{*this} == string_view{other};
+    }
+
+    constexpr bool operator==(string_view const& other) const
+    {
+        return string_view{*this} == other;
+    }
+
+    template <size_t M>
+        requires (M <= N)
+    explicit constexpr static_string(static_string<M,char_t> const& other)
+    {
+        append(other);
+    }
+};
+
+template <size_t N, typename char_t>
+static_string(const char_t (&)[N]) -> static_string<N-1,char_t>; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+} //namespace utl
@@ -0,0 +1,283 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
+#include <utl/utl.hh>
+#include <utl/error.hh>
+#include <utl/result.hh>
+#include <utl/span.hh>
+#include <utl/format.hh>
+
+namespace utl {
+
+//A vector with room for N elements, stored inline: no allocation, and
+//no separate count to keep in step with an array. Elements are only
+//constructed when they're added, and are destroyed when they're
+//removed.
+//
+//Adding to a full vector is a precondition violation, as indexing
+//past the end of an array is. Where the vector might be full, check
+//full() first, or use try_push_back/try_emplace_back, which return
+//errc::out_of_bounds instead.
+//
+//For trivially copyable types, copies and the element shuffling in
+//insert and erase are a memcpy/memmove of just the elements in use.
+template <typename T, size_t N>
+class static_vector {
+    static_assert(N > 0, "static_vector must have room for at least one element");
+
+    static constexpr bool trivial = std::is_trivially_copyable_v<T>;
+
+    //a union, so that the elements aren't constructed along with the
+    //vector
+    union {
+        T m_elements[N]; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    };
+    size_t m_size = 0;
+
+    [[nodiscard]] constexpr T* address(size_t index)
+    {
+        return &m_elements[index]; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    [[nodiscard]] constexpr T const* address(size_t index) const
+    {
+        return &m_elements[index]; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    }
+
+    void destroy(size_t first, size_t last)
+    {
+        if constexpr(not std::is_trivially_destructible_v<T>) {
+            for(size_t idx = first; idx < last; idx++) address(idx)->~T();
+        }
+    }
+
+    //Copies or moves other's elements into this (empty) vector.
+    template <typename V>
+    void construct_from(V&& other)
+    {
+        if constexpr(trivial) {
+            if(other.m_size != 0) __builtin_memcpy(address(0), other.address(0), other.m_size * sizeof(T));
+        } else {
+            for(size_t idx = 0; idx < other.m_size; idx++) {
+                if constexpr(std::is_rvalue_reference_v<V&&>) {
+                    new (address(idx)) T{std::move(other[idx])};
+                } else {
+                    new (address(idx)) T{other[idx]};
+                }
+            }
+        }
+        m_size = other.m_size;
+    }
+
+    //Opens a gap of count elements at index, moving the elements after
+    //it up. The gap is left unconstructed.
+    void open_gap(size_t index, size_t count)
+    {
+        if constexpr(trivial) {
+            __builtin_memmove(address(index + count), address(index), (m_size - index) * sizeof(T));
+        } else {
+            for(size_t idx = m_size; idx > index; idx--) {
+                new (address(idx - 1 + count)) T{std::move(*address(idx - 1))};
+                address(idx - 1)->~T();
+            }
+        }
+    }
+
+public:
+    using value_t = T;
+
+    constexpr static_vector() : m_size{0} {}
+
+    //Elements past the capacity are dropped.
+    static_vector(std::initializer_list<T> values)
+    {
+        for(auto const& value : values) {
+            if(full()) break;
+            push_back(value);
+        }
+    }
+
+    static_vector(static_vector const& other) { construct_from(other); }
+    static_vector(static_vector&& other) noexcept { construct_from(std::move(other)); }
+
+    static_vector& operator=(static_vector const& other)
+    {
+        if(this != &other) {
+            clear();
+            construct_from(other);
+        }
+        return *this;
+    }
+
+    static_vector& operator=(static_vector&& other) noexcept
+    {
+        if(this != &other) {
+            clear();
+            construct_from(std::move(other));
+        }
+        return *this;
+    }
+
+    ~static_vector() { destroy(0, m_size); }
+
+    static constexpr size_t capacity() { return N; }
+    [[nodiscard]] constexpr size_t size() const { return m_size; }
+    [[nodiscard]] constexpr size_t available() const { return N - m_size; }
+    [[nodiscard]] constexpr bool empty() const { return m_size == 0; }
+    [[nodiscard]] constexpr bool full() const { return m_size == N; }
+
+    [[nodiscard]] constexpr T* data() { return address(0); }
+    [[nodiscard]] constexpr T const* data() const { return address(0); }
+
+    constexpr T& operator[](size_t index) { return *address(index); }
+    constexpr T const& operator[](size_t index) const { return *address(index); }
+
+    [[nodiscard]] constexpr T& front() { return *address(0); }
+    [[nodiscard]] constexpr T const& front() const { return *address(0); }
+    [[nodiscard]] constexpr T& back() { return *address(m_size - 1); }
+    [[nodiscard]] constexpr T const& back() const { return *address(m_size - 1); }
+
+    [[nodiscard]] constexpr T* begin() { return address(0); }
+    [[nodiscard]] constexpr T const* begin() const { return address(0); }
+    [[nodiscard]] constexpr T* end() { return address(0) + m_size; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    [[nodiscard]] constexpr T const* end() const { return address(0) + m_size; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    [[nodiscard]] constexpr T* rbegin() { return end() - 1; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    [[nodiscard]] constexpr T const* rbegin() const { return end() - 1; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    [[nodiscard]] constexpr T* rend() { return begin() - 1; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    [[nodiscard]] constexpr T const* rend() const { return begin() - 1; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    constexpr operator utl::span<T>() { return {data(), m_size}; } //NOLINT(google-explicit-constructor)
+    constexpr operator utl::span<const T>() const { return {data(), m_size}; } //NOLINT(google-explicit-constructor)
+
+    //Requires that the vector isn't full.
+    template <typename... Args>
+    T& emplace_back(Args&&... args)
+    {
+        T* element = new (address(m_size)) T{std::forward<Args>(args)...};
+        m_size++;
+        return *element;
+    }
+
+    void push_back(T const& value) { emplace_back(value); }
+    void push_back(T&& value) { emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    result<T&> try_emplace_back(Args&&... args)
+    {
+        if(full()) return errc::out_of_bounds;
+        return success<T&>(emplace_back(std::forward<Args>(args)...));
+    }
+
+    result<void> try_push_back(T const& value)
+    {
+        if(full()) return errc::out_of_bounds;
+        emplace_back(value);
+        return success();
+    }
+
+    result<void> try_push_back(T&& value)
+    {
+        if(full()) return errc::out_of_bounds;
+        emplace_back(std::move(value));
+        return success();
+    }
+
+    void pop_back()
+    {
+        if(m_size > 0) {
+            m_size--;
+            destroy(m_size, m_size + 1);
+        }
+    }
+
+    void clear()
+    {
+        destroy(0, m_size);
+        m_size = 0;
+    }
+
+    //Shrinks the vector to count elements, or grows it (up to N) with
+    //copies of value.
+    void resize(size_t count, T const& value = T{})
+    {
+        if(count > N) count = N;
+        if(count < m_size) {
+            destroy(count, m_size);
+            m_size = count;
+        }
+        while(m_size < count) emplace_back(value);
+    }
+
+    //Inserts value before pos, moving the elements after it up.
+    //Requires that the vector isn't full.
+    template <typename... Args>
+    T* emplace(T const* pos, Args&&... args)
+    {
+        const auto index = static_cast<size_t>(pos - begin());
+        //constructed first, in case args refer to an element that's
+        //about to move
+        T value{std::forward<Args>(args)...};
+        open_gap(index, 1);
+        new (address(index)) T{std::move(value)};
+        m_size++;
+        return address(index);
+    }
+
+    T* insert(T const* pos, T const& value) { return emplace(pos, value); }
+    T* insert(T const* pos, T&& value) { return emplace(pos, std::move(value)); }
+
+    //Removes [first, last), moving the elements after them down.
+    //Returns the element that's now at first.
+    T* erase(T const* first, T const* last)
+    {
+        const auto index = static_cast<size_t>(first - begin());
+        const auto count = static_cast<size_t>(last - first);
+        if(count == 0) return address(index);
+        if constexpr(trivial) {
+            __builtin_memmove(address(index), address(index + count), (m_size - index - count) * sizeof(T));
+        } else {
+            for(size_t idx = index; idx + count < m_size; idx++) *address(idx) = std::move(*address(idx + count));
+            destroy(m_size - count, m_size);
+        }
+        m_size -= count;
+        return address(index);
+    }
+
+    T* erase(T const* pos) { return erase(pos, pos + 1); } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    template <size_t M>
+    bool operator==(static_vector<T,M> const& other) const
+    {
+        if(m_size != other.size()) return false;
+        for(size_t idx = 0; idx < m_size; idx++) {
+            if(not (*address(idx) == other[idx])) return false;
+        }
+        return true;
+    }
+};
+
+namespace fmt {
+//Formats as [a, b, c], with each element formatted by the field's spec.
+template <typename T, size_t N>
+    requires formattable<T>
+constexpr void format_arg(static_vector<T,N> const& arg, output& out, field const& f)
+{
+    out('[');
+    for(size_t idx = 0; idx < arg.size(); idx++) {
+        if(idx != 0) out(utl::string_view{", "});
+        format_arg(arg[idx], out, f);
+    }
+    out(']');
+}
+} //namespace fmt
+
+} //namespace utl
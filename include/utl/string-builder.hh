@@ -0,0 +1,204 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <utility>
+#include <utl/utl.hh>
+#include <utl/span.hh>
+#include <utl/string-view.hh>
+#include <utl/format.hh>
+
+namespace utl {
+
+//Builds a string in a buffer the caller owns, for output that's too
+//big to pass around by value (multi-kilobyte reports, JSON blobs).
+//Formatted text goes straight into the buffer, with no intermediate
+//string<N> to copy out of:
+//
+//    static char buffer[4096];
+//    utl::string_builder report{buffer};
+//    report.format("uptime: {} s\n", uptime);
+//    for(auto& rail : rails) report.format("{}: {} mV\n", rail.name, rail.mv);
+//    send(report.view());
+//
+//One character of the buffer is kept for a null terminator, so the
+//contents are always null terminated. Anything that doesn't fit is
+//dropped, and the builder remembers that it was truncated; it never
+//allocates.
+class string_builder {
+    char* m_buffer;
+    size_t m_capacity;
+    size_t m_length = 0;
+    bool m_truncated = false;
+
+    [[nodiscard]] constexpr char& access(size_t index) const
+    {
+        return m_buffer[index]; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+
+    constexpr void terminate()
+    {
+        if(m_buffer != nullptr) access(m_length) = '\0';
+    }
+
+public:
+    constexpr explicit string_builder(utl::span<char> buffer)
+        : m_buffer{buffer.size() == 0 ? nullptr : buffer.data()},
+          m_capacity{buffer.size() == 0 ? 0 : buffer.size() - 1}
+    {
+        terminate();
+    }
+
+    //Not copyable: two builders would share, and overwrite, one buffer.
+    string_builder(string_builder const&) = delete;
+    string_builder& operator=(string_builder const&) = delete;
+
+    //Moving hands the buffer over; the moved-from builder is left empty,
+    //with no buffer, so it can't write into the one it gave away.
+    constexpr string_builder(string_builder&& other)
+        : m_buffer{std::exchange(other.m_buffer, nullptr)},
+          m_capacity{std::exchange(other.m_capacity, 0)},
+          m_length{std::exchange(other.m_length, 0)},
+          m_truncated{std::exchange(other.m_truncated, false)}
+    {}
+
+    constexpr string_builder& operator=(string_builder&& other)
+    {
+        if(this != &other) {
+            m_buffer = std::exchange(other.m_buffer, nullptr);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            m_length = std::exchange(other.m_length, 0);
+            m_truncated = std::exchange(other.m_truncated, false);
+        }
+        return *this;
+    }
+
+    constexpr ~string_builder() = default;
+
+    [[nodiscard]] constexpr size_t capacity() const { return m_capacity; }
+    [[nodiscard]] constexpr size_t length() const { return m_length; }
+    [[nodiscard]] constexpr size_t size() const { return m_length; }
+    [[nodiscard]] constexpr size_t available() const { return m_capacity - m_length; }
+    [[nodiscard]] constexpr bool empty() const { return m_length == 0; }
+    [[nodiscard]] constexpr bool full() const { return m_length == m_capacity; }
+
+    //True if anything has been dropped since the builder was last
+    //cleared.
+    [[nodiscard]] constexpr bool truncated() const { return m_truncated; }
+
+    [[nodiscard]] constexpr const char* data() const { return m_buffer == nullptr ? "" : m_buffer; }
+    [[nodiscard]] constexpr const char* c_str() const { return data(); }
+    [[nodiscard]] constexpr string_view view() const { return {data(), m_length}; }
+
+    [[nodiscard]] constexpr const char* begin() const { return data(); }
+    [[nodiscard]] constexpr const char* end() const { return data() + m_length; } //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    constexpr operator string_view() const //NOLINT(google-explicit-constructor)
+    {
+        return view();
+    }
+
+    constexpr void clear()
+    {
+        m_length = 0;
+        m_truncated = false;
+        terminate();
+    }
+
+    //Drops everything after the first length characters, such as a
+    //section that turned out not to be wanted.
+    constexpr void truncate(size_t length)
+    {
+        if(length < m_length) {
+            m_length = length;
+            terminate();
+        }
+    }
+
+    //Returns false, and drops the character, if the builder is full.
+    constexpr bool push_back(char ch)
+    {
+        if(m_length == m_capacity) {
+            m_truncated = true;
+            return false;
+        }
+        access(m_length++) = ch;
+        terminate();
+        return true;
+    }
+
+    //Appends as much of view as fits. Returns the number of
+    //characters appended.
+    constexpr size_t append(string_view view)
+    {
+        size_t count = view.size();
+        if(count > available()) {
+            count = available();
+            m_truncated = true;
+        }
+        if(count == 0) return 0;
+        if(std::is_constant_evaluated()) {
+            for(size_t idx = 0; idx < count; idx++) access(m_length + idx) = view[idx];
+        } else {
+            __builtin_memcpy(&access(m_length), view.data(), count);
+        }
+        m_length += count;
+        terminate();
+        return count;
+    }
+
+    constexpr size_t append(const char* str)
+    {
+        return append(string_view{str});
+    }
+
+    constexpr size_t append(size_t count, char ch)
+    {
+        if(count > available()) {
+            count = available();
+            m_truncated = true;
+        }
+        for(size_t idx = 0; idx < count; idx++) access(m_length + idx) = ch;
+        m_length += count;
+        terminate();
+        return count;
+    }
+
+    //Formats onto the end of the builder, as format_into does.
+    template <fmt::formattable... Args>
+    constexpr string_builder& format(string_view format_string, Args&&... args)
+    {
+        format_into(*this, format_string, std::forward<Args>(args)...);
+        return *this;
+    }
+
+    constexpr string_builder& operator+=(string_view view)
+    {
+        append(view);
+        return *this;
+    }
+
+    constexpr string_builder& operator+=(const char* str)
+    {
+        append(str);
+        return *this;
+    }
+
+    constexpr string_builder& operator+=(char ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    constexpr bool operator==(string_view const& other) const
+    {
+        return view() == other;
+    }
+};
+
+} //namespace utl
@@ -10,6 +10,7 @@
 #include <utl/utl.hh>
 #include <utl/type-list.hh>
 #include <utl/concepts.hh>
+#include <utl/bits/string_search.hh>
 
 namespace utl {
 
@@ -94,27 +95,13 @@ public:
         return data();
     }
 
-    //This function is only recursive during constant evaluation.
-    //FIXME: change to if consteval when supported
-    //NOLINTNEXTLINE(misc-no-recursion)
     [[nodiscard]] constexpr bool starts_with(string_view v) const
     {
         if(v.length() > length()) { return false; }
-        if(length() == 0 && v.length() == 0) { return true; }
-        if(length() == 0) { return false; }
         if (std::is_constant_evaluated()) {
-            if(access(0) == v.access(0)) {
-                if(v.length() == 1) { return true; }
-                return substr(1,npos).starts_with(v.substr(1, npos));
-            } else {
-                return false;
-            }
-        } else {
-            for(size_t idx = 0; idx < v.length(); idx++) {
-                if(access(idx) != v.access(idx)) return false;
-            }
-            return true;
+            return search::equal(data(), v.data(), v.length());
         }
+        return v.length() == 0 or __builtin_memcmp(data(), v.data(), v.length()) == 0;
     }
 
     [[nodiscard]] constexpr bool starts_with(char v) const
@@ -122,54 +109,19 @@ public:
         return access(0) == v;
     }
 
-    //This function is only recursive during constant evaluation.
-    //FIXME: change to if consteval when supported
-    //NOLINTNEXTLINE(misc-no-recursion)
     [[nodiscard]] constexpr size_t find(string_view v, size_t pos = 0) const
-    {        
-        if(length() == 0) { return npos; }
-        if(v.length() > length()) { return npos; }
-        if(pos >= length()) { return npos; }
-        const size_t search_end_pos = length() - v.length();
-        if(pos > search_end_pos) { return npos; }
-
-        auto check = [&](auto p) {
-            return substr(p,npos).starts_with(v);
-        };
+    {
+        return search::find(data(), length(), v.data(), v.length(), pos);
+    }
 
-        if (std::is_constant_evaluated()) {
-            if(check(pos)) { return pos; }
-            return find(v, pos + 1);
-        } else {
-            for(size_t idx = pos; idx <= search_end_pos; idx++) {
-                if(check(idx)) { return idx; }
-            }
-            return npos;
-        }
+    [[nodiscard]] constexpr size_t find(char c, size_t pos = 0) const
+    {
+        return search::find(data(), length(), &c, 1, pos);
     }
 
     [[nodiscard]] constexpr size_t rfind(string_view v, size_t pos = npos) const
-    {        
-        if(length() == 0) { return npos; }
-        if(v.length() > length()) { return npos; }
-        const size_t last_searchable_pos = length() - v.length();
-        if(pos > last_searchable_pos) { pos = last_searchable_pos; }
-
-        auto check = [&](auto p) {
-            return substr(p,npos).starts_with(v);
-        };
-
-        if (std::is_constant_evaluated()) {
-            if(check(pos)) { return pos; }
-            if(pos == 0) { return npos; }
-            return find(v, pos - 1);
-        } else {
-            for(size_t idx = pos; idx > 0u; idx--) {
-                if(check(pos)) { return pos; }
-            }
-            if(check(0u)) { return 0u; }
-            return npos;
-        }
+    {
+        return search::rfind(data(), length(), v.data(), v.length(), pos);
     }
 
     [[nodiscard]] constexpr bool compare(string_view v) const
@@ -180,50 +180,13 @@ public:
     }
 
     [[nodiscard]] constexpr size_t find(string_view v, size_t pos = 0) const
-    {        
-        if(size() == 0) { return npos; }
-        if(v.size() > size()) { return npos; }
-        if(pos >= size()) { return npos; }
-        const size_t search_end_pos = size() - v.size();
-        if(pos > search_end_pos) { return npos; }
-
-        auto check = [&](auto p) {
-            return substr(p,npos).starts_with(v);
-        };
-
-        // if (std::is_constant_evaluated()) {
-        //     if(check(pos)) { return pos; }
-        //     return find(v, pos + 1);
-        // } else {
-            for(size_t idx = pos; idx <= search_end_pos; idx++) {
-                if(check(idx)) { return idx; }
-            }
-            return npos;
-        // }
+    {
+        return search::find(data(), size(), v.data(), v.length(), pos);
     }
 
     [[nodiscard]] constexpr size_t rfind(string_view v, size_t pos = npos) const
-    {        
-        if(size() == 0) { return npos; }
-        if(v.size() > size()) { return npos; }
-        const size_t last_searchable_pos = size() - v.size();
-        if(pos > last_searchable_pos) { pos = last_searchable_pos; }
-
-        auto check = [&](auto p) {
-            return substr(p,npos).starts_with(v);
-        };
-
-        if (std::is_constant_evaluated()) {
-            if(check(pos)) { return pos; }
-            if(pos == 0) { return npos; }
-            return find(v, pos - 1);
-        } else {
-            for(size_t idx = pos; idx > 0u; idx--) {
-                if(check(pos)) { return pos; }
-            }
-            if(check(0u)) { return 0u; }
-            return npos;
-        }
+    {
+        return search::rfind(data(), size(), v.data(), v.length(), pos);
     }
 
     [[nodiscard]] constexpr int compare(string_view v) const
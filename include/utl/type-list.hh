@@ -13,6 +13,7 @@
 #include <utl/traits.hh>
 #include <utl/tuple.hh>
 #include <utility>
+#include <concepts>
 
 namespace utl {
 
@@ -40,6 +41,14 @@ namespace utl {
 // template <size_t L>
 // using make_index_sequence = std::make_index_sequence<L>;
 
+//Use the compiler's pack indexing where it's available; the recursive
+//version instantiates N templates for every lookup.
+#if __has_builtin(__type_pack_element)
+template <size_t N, typename... Ts>
+struct get_type {
+    using type = __type_pack_element<N,Ts...>;
+};
+#else
 template <size_t N, typename... Ts>
 struct get_type;
 
@@ -50,6 +59,7 @@ template<typename T, typename... Ts>
 struct get_type<0, T, Ts...> {
     using type = T;
 };
+#endif
 
 template <size_t N, typename... Ts>
 using get_t = typename get_type<N,Ts...>::type;
@@ -81,28 +91,35 @@ struct type_list {
 };
 
 namespace detail {
-    template <size_t N, typename T, typename... Ts>
-    struct get_type_index;
+    //index of the first match, or sizeof...(Ts)
+    template <typename T, typename... Ts>
+    consteval size_t find_type_index()
+    {
+        constexpr bool matches[] = {std::same_as<Ts,T>..., false}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+        for(size_t idx = 0; idx < sizeof...(Ts); idx++) {
+            if(matches[idx]) return idx; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        return sizeof...(Ts);
+    }
 
-    template <size_t N, typename T, typename... Ts>
+    template <typename T, typename... Ts>
     struct get_type_index {
         static_assert((std::same_as<Ts,T> || ...), "type list does not contain T");
 
-        static constexpr size_t value = std::same_as<get_t<N,Ts...>,T> ? N : get_type_index<N-1,T,Ts...>::value;
-    };
-
-    template <typename T, typename... Ts>
-    struct get_type_index<0,T,Ts...> {
-        static constexpr size_t value = 0;
+        static constexpr size_t value = find_type_index<T,Ts...>();
     };
 }
 
 template <typename T, typename... Ts>
-struct get_type_index : detail::get_type_index<sizeof...(Ts) - 1,T,Ts...> {};
+struct get_type_index : detail::get_type_index<T,Ts...> {};
 
 template <typename T, typename... Ts>
 inline constexpr size_t get_type_index_v = get_type_index<T,Ts...>::value;
 
+//Like get_type_index_v, but sizeof...(Ts) if T isn't in the list.
+template <typename T, typename... Ts>
+inline constexpr size_t find_type_index_v = detail::find_type_index<T,Ts...>();
+
 
 template <typename T, typename... Ts>
 constexpr auto get(tuple<Ts...>& t)
@@ -0,0 +1,273 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <utl/utl.hh>
+#include <utl/result.hh>
+#include <utl/span.hh>
+#include <utl/string-view.hh>
+
+namespace utl::utf8 {
+
+//UTF-8 validation, decoding, and transcoding to UTF-16LE (for USB
+//string descriptors). Text is mostly ASCII, so at runtime every loop
+//here skips over ASCII a block at a time: 16 bytes with SSE2 where the
+//host has it, otherwise 8 bytes in a word. Multibyte sequences, and
+//everything during constant evaluation, go through the scalar decoder.
+//
+//The SSE2 paths use the compiler's vector extensions and builtins
+//rather than <emmintrin.h>, which isn't available in every toolchain.
+
+inline constexpr char32_t replacement = 0xFFFD;
+
+namespace detail {
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+#if defined(__SSE2__)
+    using block_t = uint8_t __attribute__((vector_size(16)));
+    using wide_block_t = uint16_t __attribute__((vector_size(32)));
+    using movemask_t = char __attribute__((vector_size(16)));
+#endif
+
+    struct decoded {
+        char32_t codepoint;
+        size_t length; //bytes consumed; at least one
+        bool valid;
+    };
+
+    //Decodes the sequence at bytes. An invalid sequence consumes its
+    //longest valid prefix (at least one byte), as Unicode recommends
+    //when substituting U+FFFD.
+    constexpr decoded decode(const uint8_t* bytes, size_t available)
+    {
+        const uint8_t lead = bytes[0];
+        if(lead < 0x80) return {lead, 1, true};
+
+        size_t length = 0;
+        char32_t codepoint = 0;
+        uint8_t low = 0x80; //the range allowed for the second byte
+        uint8_t high = 0xBF;
+        if(lead >= 0xC2 and lead <= 0xDF) {
+            length = 2;
+            codepoint = lead & 0x1F;
+        } else if(lead >= 0xE0 and lead <= 0xEF) {
+            length = 3;
+            codepoint = lead & 0x0F;
+            if(lead == 0xE0) low = 0xA0;  //overlong
+            if(lead == 0xED) high = 0x9F; //surrogates
+        } else if(lead >= 0xF0 and lead <= 0xF4) {
+            length = 4;
+            codepoint = lead & 0x07;
+            if(lead == 0xF0) low = 0x90;  //overlong
+            if(lead == 0xF4) high = 0x8F; //past U+10FFFF
+        } else {
+            return {replacement, 1, false};
+        }
+
+        for(size_t idx = 1; idx < length; idx++) {
+            if(idx >= available) return {replacement, idx, false};
+            const uint8_t byte = bytes[idx];
+            if(byte < low or byte > high) return {replacement, idx, false};
+            codepoint = (codepoint << 6) | (byte & 0x3F);
+            low = 0x80;
+            high = 0xBF;
+        }
+        return {codepoint, length, true};
+    }
+
+    //The number of ASCII bytes at the start of bytes, found a block at
+    //a time. Stops short of the end; the caller finishes up.
+    inline size_t ascii_prefix(const uint8_t* bytes, size_t size)
+    {
+        size_t idx = 0;
+#if defined(__SSE2__)
+        for(; idx + 16 <= size; idx += 16) {
+            block_t block{};
+            __builtin_memcpy(&block, bytes + idx, sizeof(block));
+            const auto high_bits = static_cast<unsigned>(__builtin_ia32_pmovmskb128(reinterpret_cast<movemask_t>(block))); //NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+            if(high_bits != 0) return idx + static_cast<size_t>(__builtin_ctz(high_bits));
+        }
+#endif
+        for(; idx + sizeof(uint64_t) <= size; idx += sizeof(uint64_t)) {
+            uint64_t word = 0;
+            __builtin_memcpy(&word, bytes + idx, sizeof(word));
+            if((word & 0x8080'8080'8080'8080) != 0) break;
+        }
+        return idx;
+    }
+
+    constexpr void put16(uint8_t* out, char16_t unit)
+    {
+        out[0] = static_cast<uint8_t>(unit);
+        out[1] = static_cast<uint8_t>(unit >> 8);
+    }
+
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+} //namespace detail
+
+//The offset of the first byte that isn't part of a valid UTF-8
+//sequence, or the size of the input if it's all valid.
+constexpr size_t find_invalid(utl::span<const uint8_t> text)
+{
+    const uint8_t* bytes = text.data();
+    const size_t size = text.size();
+    size_t idx = 0;
+    while(idx < size) {
+        //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(not std::is_constant_evaluated()) idx += detail::ascii_prefix(bytes + idx, size - idx);
+        if(idx == size) break;
+        const auto seq = detail::decode(bytes + idx, size - idx);
+        //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(not seq.valid) return idx;
+        idx += seq.length;
+    }
+    return size;
+}
+
+[[nodiscard]] constexpr bool validate(utl::span<const uint8_t> text)
+{
+    return find_invalid(text) == text.size();
+}
+
+[[nodiscard]] inline bool validate(string_view text)
+{
+    return validate({reinterpret_cast<const uint8_t*>(text.data()), text.size()}); //NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+//The codepoints of some UTF-8 text, decoded as the range is iterated.
+//Invalid sequences come out as U+FFFD.
+class codepoint_view {
+    const uint8_t* m_bytes;
+    size_t m_size;
+
+public:
+    class iterator {
+        const uint8_t* m_bytes;
+        size_t m_size;
+        size_t m_position;
+        detail::decoded m_current{};
+
+        constexpr void decode()
+        {
+            if(m_position < m_size) m_current = detail::decode(m_bytes + m_position, m_size - m_position); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+    public:
+        constexpr iterator(const uint8_t* bytes, size_t size, size_t position)
+            : m_bytes{bytes}, m_size{size}, m_position{position}
+        {
+            decode();
+        }
+
+        constexpr char32_t operator*() const { return m_current.codepoint; }
+
+        //The offset of the current codepoint's first byte.
+        [[nodiscard]] constexpr size_t position() const { return m_position; }
+
+        constexpr iterator& operator++()
+        {
+            m_position += m_current.length;
+            decode();
+            return *this;
+        }
+
+        constexpr iterator operator++(int)
+        {
+            auto previous = *this;
+            operator++();
+            return previous;
+        }
+
+        constexpr bool operator==(iterator const& other) const { return m_position == other.m_position; }
+    };
+
+    constexpr explicit codepoint_view(utl::span<const uint8_t> text) : m_bytes{text.data()}, m_size{text.size()} {}
+
+    [[nodiscard]] constexpr iterator begin() const { return {m_bytes, m_size, 0}; }
+    [[nodiscard]] constexpr iterator end() const { return {m_bytes, m_size, m_size}; }
+};
+
+constexpr codepoint_view codepoints(utl::span<const uint8_t> text)
+{
+    return codepoint_view{text};
+}
+
+inline codepoint_view codepoints(string_view text)
+{
+    return codepoint_view{{reinterpret_cast<const uint8_t*>(text.data()), text.size()}}; //NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+//The number of bytes text takes as UTF-16: two per codepoint below
+//U+10000, four above. Invalid sequences count as U+FFFD.
+constexpr size_t utf16_size(utl::span<const uint8_t> text)
+{
+    size_t total = 0;
+    for(auto codepoint : codepoints(text)) total += codepoint >= 0x10000 ? 4 : 2;
+    return total;
+}
+
+//Writes text to out as UTF-16LE, the encoding of USB string
+//descriptors, replacing invalid sequences with U+FFFD. Returns the
+//number of bytes written, or errc::out_of_bounds if out is too small
+//(in which case as many whole codepoints as fit are written).
+constexpr result<size_t> to_utf16le(utl::span<const uint8_t> text, utl::span<uint8_t> out)
+{
+    //NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    const uint8_t* bytes = text.data();
+    const size_t size = text.size();
+    uint8_t* dest = out.data();
+    size_t idx = 0;
+    size_t written = 0;
+    while(idx < size) {
+        if(not std::is_constant_evaluated()) {
+            //widen runs of ASCII directly
+            size_t run = detail::ascii_prefix(bytes + idx, size - idx);
+            if(run > (out.size() - written) / 2) run = (out.size() - written) / 2;
+            size_t done = 0;
+#if defined(__SSE2__)
+            //SSE2 hosts are little endian, so zero extending each byte
+            //is exactly UTF-16LE
+            for(; done + 16 <= run; done += 16) {
+                detail::block_t block{};
+                __builtin_memcpy(&block, bytes + idx + done, sizeof(block));
+                const auto wide = __builtin_convertvector(block, detail::wide_block_t);
+                __builtin_memcpy(dest + written + 2 * done, &wide, sizeof(wide));
+            }
+#endif
+            for(; done < run; done++) detail::put16(dest + written + 2 * done, bytes[idx + done]);
+            idx += run;
+            written += 2 * run;
+            if(idx == size) break;
+        }
+
+        const auto seq = detail::decode(bytes + idx, size - idx);
+        const char32_t codepoint = seq.codepoint;
+        if(codepoint >= 0x10000) {
+            if(out.size() - written < 4) return errc::out_of_bounds;
+            const auto offset = codepoint - 0x10000;
+            detail::put16(dest + written, static_cast<char16_t>(0xD800 + (offset >> 10)));
+            detail::put16(dest + written + 2, static_cast<char16_t>(0xDC00 + (offset & 0x3FF)));
+            written += 4;
+        } else {
+            if(out.size() - written < 2) return errc::out_of_bounds;
+            detail::put16(dest + written, static_cast<char16_t>(codepoint));
+            written += 2;
+        }
+        idx += seq.length;
+    }
+    return written;
+    //NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+inline result<size_t> to_utf16le(string_view text, utl::span<uint8_t> out)
+{
+    return to_utf16le({reinterpret_cast<const uint8_t*>(text.data()), text.size()}, out); //NOLINT(cppcoreguidelines-pro-type-reinterpret-cast)
+}
+
+} //namespace utl::utf8
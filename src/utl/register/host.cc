@@ -0,0 +1,133 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+
+#include "utl/register/host.hh"
+
+namespace utl::registers::host {
+
+namespace {
+    uint64_t truncate(uint64_t value, size_t width)
+    {
+        constexpr size_t max_width = 64;
+        if(width >= max_width) return value;
+        return value & ((uint64_t{1} << width) - 1);
+    }
+} //anonymous namespace
+
+register_file::cell const* register_file::find(uintptr_t address) const
+{
+    for(size_t idx = 0; idx < m_n_cells; idx++) {
+        if(m_cells[idx].address == address) return &m_cells[idx];
+    }
+    return nullptr;
+}
+
+register_file::cell* register_file::find_or_insert(uintptr_t address, uint64_t reset_value)
+{
+    for(size_t idx = 0; idx < m_n_cells; idx++) {
+        if(m_cells[idx].address == address) return &m_cells[idx];
+    }
+    if(m_n_cells == max_registers) {
+        m_dropped_registers = true;
+        return nullptr;
+    }
+    m_cells[m_n_cells] = {address, reset_value, 0, 0};
+    return &m_cells[m_n_cells++];
+}
+
+void register_file::record(cell* c, uintptr_t address, size_t width, uint64_t value, direction dir)
+{
+    if(dir == direction::read) m_reads++;
+    else m_writes++;
+    if(c != nullptr) {
+        if(dir == direction::read) c->reads++;
+        else c->writes++;
+    }
+    if(m_n_accesses < max_accesses) {
+        m_trace[m_n_accesses++] = {address, width, value, dir};
+    }
+}
+
+uint64_t register_file::read(uintptr_t address, size_t width, uint64_t reset_value)
+{
+    auto* c = find_or_insert(address, truncate(reset_value, width));
+    const auto value = c == nullptr ? truncate(reset_value, width) : truncate(c->value, width);
+    record(c, address, width, value, direction::read);
+    return value;
+}
+
+void register_file::write(uintptr_t address, size_t width, uint64_t value)
+{
+    value = truncate(value, width);
+    auto* c = find_or_insert(address, value);
+    if(c != nullptr) c->value = value;
+    record(c, address, width, value, direction::write);
+}
+
+uint64_t register_file::peek(uintptr_t address, uint64_t reset_value) const
+{
+    const auto* c = find(address);
+    return c == nullptr ? reset_value : c->value;
+}
+
+void register_file::poke(uintptr_t address, uint64_t value)
+{
+    auto* c = find_or_insert(address, value);
+    if(c != nullptr) c->value = value;
+}
+
+size_t register_file::count(uintptr_t address, direction dir) const
+{
+    const auto* c = find(address);
+    if(c == nullptr) return 0;
+    return dir == direction::read ? c->reads : c->writes;
+}
+
+void register_file::clear_trace()
+{
+    m_n_accesses = 0;
+    m_reads = 0;
+    m_writes = 0;
+    for(size_t idx = 0; idx < m_n_cells; idx++) {
+        m_cells[idx].reads = 0;
+        m_cells[idx].writes = 0;
+    }
+}
+
+void register_file::reset()
+{
+    clear_trace();
+    m_n_cells = 0;
+    m_dropped_registers = false;
+}
+
+namespace {
+    //NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    register_file default_file{};
+
+    //NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+    register_file* global_file = &default_file;
+} //anonymous namespace
+
+register_file& get_register_file()
+{
+    return *global_file;
+}
+
+push_register_file::push_register_file(register_file& file)
+    : m_previous_file{global_file}
+{
+    global_file = &file;
+}
+
+push_register_file::~push_register_file()
+{
+    global_file = m_previous_file;
+}
+
+} //namespace utl::registers::host
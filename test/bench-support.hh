@@ -0,0 +1,86 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+#pragma once
+
+#include <stdint.h>
+#include <time.h>
+#include <utl/utl.hh>
+#include <utl/string-view.hh>
+#include <utl/logger.hh>
+
+//Minimal timing helpers for the benchmark test groups. These run as
+//part of the normal test binary and report through utl::log; they
+//don't assert on timings, since those depend on the host.
+namespace utl::bench {
+
+//A small, repeatable pseudorandom sequence, for test and benchmark
+//inputs. Each call gives the top 24 bits of a 32-bit LCG.
+struct lcg {
+    uint32_t state;
+    uint32_t operator()()
+    {
+        state = state * 1664525u + 1013904223u;
+        return state >> 8;
+    }
+};
+
+//Forces the optimizer to assume the value is observed, so a loop
+//that only exists to be timed isn't discarded.
+template <typename T>
+inline void keep(T const& value)
+{
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+inline uint64_t now_ns()
+{
+    timespec ts{};
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    constexpr uint64_t ns_per_s = 1000000000u;
+    return static_cast<uint64_t>(ts.tv_sec) * ns_per_s + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+struct measurement {
+    size_t iterations;
+    uint64_t elapsed_ns;
+
+    [[nodiscard]] uint64_t ps_per_iteration() const
+    {
+        constexpr uint64_t ps_per_ns = 1000u;
+        if(iterations == 0) return 0;
+        return (elapsed_ns * ps_per_ns) / iterations;
+    }
+};
+
+template <typename F>
+inline measurement measure(size_t iterations, F&& body)
+{
+    const auto start = now_ns();
+    for(size_t idx = 0; idx < iterations; idx++) {
+        body(idx);
+    }
+    return {iterations, now_ns() - start};
+}
+
+inline void report(utl::string_view name, measurement m)
+{
+    utl::log("bench {}: {} iterations, {} ps/iteration", name, m.iterations, m.ps_per_iteration());
+}
+
+//Reports a candidate against a baseline; speedup is in percent,
+//so 250 means the candidate took 40% of the baseline's time.
+inline void report(utl::string_view name, measurement baseline, measurement candidate)
+{
+    constexpr uint64_t percent = 100u;
+    const uint64_t speedup = candidate.elapsed_ns == 0 ? 0 :
+        (baseline.elapsed_ns * percent) / candidate.elapsed_ns;
+    utl::log("bench {}: baseline {} ps/iteration, candidate {} ps/iteration, speedup {}%", name,
+        baseline.ps_per_iteration(), candidate.ps_per_iteration(), speedup);
+}
+
+} //namespace utl::bench
@@ -0,0 +1,216 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/ranges.hh>
+#include <utl/ranges/adaptors.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+using namespace utl::ranges;
+
+namespace {
+
+constexpr int sum(auto&& range)
+{
+    int total = 0;
+    for(auto value : range) total += value;
+    return total;
+}
+
+constexpr utl::array<int,8> values{1, 2, 3, 4, 5, 6, 7, 8};
+constexpr auto is_even = [](int v) { return v % 2 == 0; };
+constexpr auto square = [](int v) { return v * v; };
+
+static_assert(sum(values | filter(is_even) | transform(square)) == 4 + 16 + 36 + 64);
+static_assert(sum(iota(0, 100) | stride(10) | take(3)) == 0 + 10 + 20);
+static_assert(sum(iota(1) | drop(2) | take(2)) == 3 + 4);
+static_assert(iterable<decltype(values | transform(square))>);
+
+//a range that's a temporary, rather than something to refer to
+constexpr utl::array<int,4> make_values() { return {10, 20, 30, 40}; }
+
+constexpr bool is_empty(auto&& range)
+{
+    return not (utl::ranges::begin(range) != utl::ranges::end(range));
+}
+
+template <size_t N>
+void check_values(auto&& range, int const (&expected)[N]) //NOLINT(cppcoreguidelines-avoid-c-arrays)
+{
+    size_t idx = 0;
+    for(auto value : range) {
+        CHECK(idx < N);
+        if(idx < N) CHECK_EQUAL(expected[idx], value); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        idx++;
+    }
+    CHECK_EQUAL(N, idx);
+}
+
+} //anonymous namespace
+
+TEST_GROUP(Adaptors) {};
+
+TEST(Adaptors,Transform)
+{
+    check_values(transform(values, square), {1, 4, 9, 16, 25, 36, 49, 64});
+    check_values(make_values() | transform([](int v) { return v / 10; }), {1, 2, 3, 4});
+}
+
+TEST(Adaptors,Filter)
+{
+    check_values(values | filter(is_even), {2, 4, 6, 8});
+    CHECK(is_empty(values | filter([](int v) { return v > 100; })));
+}
+
+TEST(Adaptors,TakeAndDrop)
+{
+    check_values(values | take(3), {1, 2, 3});
+    check_values(values | take(20), {1, 2, 3, 4, 5, 6, 7, 8});
+    check_values(values | drop(6), {7, 8});
+    CHECK(is_empty(values | drop(20)));
+    check_values(values | drop(2) | take(2), {3, 4});
+}
+
+TEST(Adaptors,Stride)
+{
+    check_values(values | stride(3), {1, 4, 7});
+    check_values(values | stride(1), {1, 2, 3, 4, 5, 6, 7, 8});
+}
+
+TEST(Adaptors,Chunk)
+{
+    int sums[3] = {}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    size_t idx = 0;
+    for(auto block : values | chunk(3)) {
+        CHECK(idx < 3);
+        if(idx < 3) sums[idx] = sum(block); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        idx++;
+    }
+    CHECK_EQUAL(3u, idx);
+    CHECK_EQUAL(1 + 2 + 3, sums[0]);
+    CHECK_EQUAL(4 + 5 + 6, sums[1]);
+    CHECK_EQUAL(7 + 8, sums[2]);
+}
+
+TEST(Adaptors,Zip)
+{
+    const utl::array<char,3> names{'a', 'b', 'c'};
+    size_t idx = 0;
+    for(auto [value, name] : zip(values, names)) {
+        CHECK_EQUAL(static_cast<int>(idx) + 1, value);
+        CHECK_EQUAL('a' + static_cast<char>(idx), name);
+        idx++;
+    }
+    //the shortest range decides
+    CHECK_EQUAL(3u, idx);
+
+    //elements are referred to, so they can be written through
+    utl::array<int,3> out{};
+    for(auto [dest, src] : zip(out, values | transform(square))) dest = src;
+    CHECK_EQUAL(9, out[2]);
+}
+
+TEST(Adaptors,Iota)
+{
+    check_values(iota(3, 6), {3, 4, 5});
+    CHECK(is_empty(iota(5, 5)));
+    check_values(iota(7) | take(2), {7, 8});
+}
+
+TEST(Adaptors,Enumerate)
+{
+    //enumerate can be composed with the adaptors, and can be given
+    //ranges that produce values
+    size_t expected = 0;
+    for(auto [idx, value] : enumerate(values | transform(square))) {
+        CHECK_EQUAL(expected, idx);
+        CHECK_EQUAL(static_cast<int>((idx + 1) * (idx + 1)), value);
+        expected++;
+    }
+    CHECK_EQUAL(8u, expected);
+    CHECK_EQUAL(10 + 20 + 30 + 40, sum(enumerate(make_values()) | transform([](auto pair) { return utl::get<1>(pair); })));
+}
+
+TEST(Adaptors,Arrays)
+{
+    //the end of a C array is one past its last element
+    const int raw[4] = {1, 2, 3, 4}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    CHECK_EQUAL(10, sum(raw));
+    check_values(raw | drop(3), {4});
+}
+
+TEST_GROUP(AdaptorsBenchmark) {};
+
+namespace {
+
+utl::array<int,4096>& benchmark_samples()
+{
+    static utl::array<int,4096> samples{};
+    for(size_t idx = 0; idx < samples.size(); idx++) samples[idx] = static_cast<int>((idx * 7919) % 1000) - 500;
+    return samples;
+}
+
+} //anonymous namespace
+
+TEST(AdaptorsBenchmark,StrideTransform)
+{
+    constexpr size_t iterations = 2000;
+    auto& samples = benchmark_samples();
+
+    //the loop the pipeline stands in for
+    int expected = 0;
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        int total = 0;
+        for(size_t idx = 0; idx < samples.size(); idx += 2) total += samples[idx] * 3;
+        utl::bench::keep(total);
+        expected = total;
+    });
+    int found = 0;
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        int total = 0;
+        for(auto value : samples | stride(2) | transform([](int v) { return v * 3; })) total += value;
+        utl::bench::keep(total);
+        found = total;
+    });
+    //should be close to 100%: this compiles down to the same loop
+    utl::bench::report("stride and transform 4096 samples"_sv, baseline, candidate);
+    CHECK_EQUAL(expected, found);
+}
+
+TEST(AdaptorsBenchmark,Filter)
+{
+    constexpr size_t iterations = 2000;
+    auto& samples = benchmark_samples();
+
+    int expected = 0;
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        int total = 0;
+        for(size_t idx = 0; idx < samples.size(); idx++) {
+            if(samples[idx] > 0) total += samples[idx];
+        }
+        utl::bench::keep(total);
+        expected = total;
+    });
+    int found = 0;
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        int total = 0;
+        for(auto value : samples | filter([](int v) { return v > 0; })) total += value;
+        utl::bench::keep(total);
+        found = total;
+    });
+    //slower: skipping to the next match is a loop of its own, which
+    //keeps the optimizer from vectorizing the whole thing as it does
+    //the hand-written loop
+    utl::bench::report("filter 4096 samples"_sv, baseline, candidate);
+    CHECK_EQUAL(expected, found);
+}
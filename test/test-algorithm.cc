@@ -0,0 +1,259 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <algorithm>
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/span.hh>
+#include <utl/algorithm.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+constexpr auto sorted_constant()
+{
+    utl::array<int,24> values{9, 3, 7, 1, 8, 2, 6, 4, 5, 0, 23, 11, 19, 13, 17, 15, 21, 12, 22, 10, 20, 14, 18, 16};
+    utl::sort(values);
+    return values;
+}
+
+constexpr auto sorted_network()
+{
+    utl::array<int,5> values{4, 1, 3, 0, 2};
+    utl::sort(values, [](int a, int b) { return a > b; });
+    return values;
+}
+
+static_assert(sorted_constant()[0] == 0 and sorted_constant()[23] == 23);
+static_assert(sorted_network()[0] == 4 and sorted_network()[4] == 0);
+static_assert(*utl::max_element(sorted_constant()) == 23);
+static_assert(utl::accumulate(sorted_network(), 0) == 10);
+
+template <typename I, typename C = utl::less>
+bool is_sorted(I first, I last, C comp = {})
+{
+    for(auto iter = first; iter + 1 < last; ++iter) { //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        if(comp(*(iter + 1), *iter)) return false; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return true;
+}
+
+//the inputs that tend to trip up quicksorts
+void fill(utl::span<int> values, size_t pattern, utl::bench::lcg& random)
+{
+    const auto size = values.size();
+    for(size_t idx = 0; idx < size; idx++) {
+        switch(pattern) {
+            case 0: values[idx] = static_cast<int>(random() % 1000); break;
+            case 1: values[idx] = static_cast<int>(idx); break;
+            case 2: values[idx] = static_cast<int>(size - idx); break;
+            case 3: values[idx] = 7; break;
+            case 4: values[idx] = static_cast<int>(idx < size / 2 ? idx : size - idx); break;
+            default: values[idx] = static_cast<int>(random() % 4); break;
+        }
+    }
+}
+
+struct keyed {
+    int key;
+    size_t order;
+};
+
+} //anonymous namespace
+
+TEST_GROUP(Algorithm) {};
+
+TEST(Algorithm,Sort)
+{
+    utl::bench::lcg random{1};
+    static utl::array<int,1000> values{};
+    static utl::array<int,1000> expected{};
+    for(size_t size : {0u, 1u, 2u, 3u, 15u, 16u, 17u, 100u, 1000u}) {
+        for(size_t pattern = 0; pattern < 6; pattern++) {
+            auto view = utl::span<int>{values.data(), size};
+            fill(view, pattern, random);
+            for(size_t idx = 0; idx < size; idx++) expected[idx] = values[idx];
+            std::sort(expected.data(), expected.data() + size); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            utl::sort(view);
+            for(size_t idx = 0; idx < size; idx++) CHECK_EQUAL(expected[idx], values[idx]);
+        }
+    }
+
+    int raw[20] = {5, 3, 1, 4, 2, 19, 17, 18, 16, 15, 0, 6, 8, 7, 9, 10, 12, 11, 14, 13}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    utl::sort(raw);
+    CHECK(is_sorted(utl::ranges::begin(raw), utl::ranges::end(raw)));
+}
+
+TEST(Algorithm,SortingNetwork)
+{
+    //a network that sorts every sequence of 0s and 1s sorts anything
+    utl::array<uint8_t,16> sixteen{};
+    for(uint32_t bits = 0; bits < (1u << 16); bits++) {
+        for(size_t idx = 0; idx < 16; idx++) sixteen[idx] = (bits >> idx) & 1u;
+        utl::sort(sixteen);
+        CHECK(is_sorted(sixteen.begin(), sixteen.end()));
+    }
+    utl::array<uint8_t,11> eleven{};
+    for(uint32_t bits = 0; bits < (1u << 11); bits++) {
+        for(size_t idx = 0; idx < 11; idx++) eleven[idx] = (bits >> idx) & 1u;
+        utl::sort(eleven);
+        CHECK(is_sorted(eleven.begin(), eleven.end()));
+    }
+
+    int raw[3] = {3, 1, 2}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    utl::sort(raw);
+    CHECK_EQUAL(1, raw[0]);
+    CHECK_EQUAL(3, raw[2]);
+}
+
+TEST(Algorithm,StableSort)
+{
+    utl::bench::lcg random{2};
+    static utl::array<keyed,500> values{};
+    static utl::array<keyed,250> scratch{};
+    const auto by_key = [](keyed const& a, keyed const& b) { return a.key < b.key; };
+    const auto by_key_then_order = [](keyed const& a, keyed const& b) {
+        return a.key < b.key or (a.key == b.key and a.order < b.order);
+    };
+    //with room for half, with less, and with none
+    for(size_t room : {250u, 40u, 0u}) {
+        for(size_t idx = 0; idx < values.size(); idx++) values[idx] = {static_cast<int>(random() % 10), idx};
+        utl::stable_sort(values, utl::span<keyed>{scratch.data(), room}, by_key);
+        CHECK(is_sorted(values.begin(), values.end(), by_key_then_order));
+    }
+}
+
+TEST(Algorithm,NthElement)
+{
+    utl::bench::lcg random{3};
+    utl::array<int,101> values{};
+    for(size_t nth : {0u, 50u, 100u}) {
+        for(auto& value : values) value = static_cast<int>(random() % 1000);
+        utl::array<int,101> sorted = values;
+        std::sort(sorted.begin(), sorted.end());
+        utl::nth_element(values, nth);
+        CHECK_EQUAL(sorted[nth], values[nth]);
+        for(size_t idx = 0; idx < nth; idx++) CHECK(values[idx] <= values[nth]);
+        for(size_t idx = nth + 1; idx < values.size(); idx++) CHECK(values[idx] >= values[nth]);
+    }
+}
+
+TEST(Algorithm,Bounds)
+{
+    const utl::array<int,7> values{1, 2, 2, 2, 5, 8, 9};
+    CHECK_EQUAL(1, utl::lower_bound(values, 2) - values.begin());
+    CHECK_EQUAL(4, utl::upper_bound(values, 2) - values.begin());
+    CHECK_EQUAL(4, utl::lower_bound(values, 3) - values.begin());
+    CHECK_EQUAL(0, utl::lower_bound(values, 0) - values.begin());
+    CHECK(utl::lower_bound(values, 10) == values.end());
+
+    //pointer pairs take the iterator overloads, not the range ones
+    const int* first = values.data();
+    const int* last = first + values.size(); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    CHECK_EQUAL(1, utl::lower_bound(first, last, 2) - first);
+    CHECK_EQUAL(4, utl::upper_bound(first, last, 2) - first);
+    CHECK_EQUAL(4, utl::lower_bound(first, last, 3) - first);
+    CHECK(utl::upper_bound(first, last, 9) == last);
+}
+
+TEST(Algorithm,Partition)
+{
+    utl::array<int,9> values{1, 2, 3, 4, 5, 6, 7, 8, 9};
+    const auto is_even = [](int v) { return v % 2 == 0; };
+    auto split = utl::partition(values, is_even);
+    CHECK_EQUAL(4, split - values.begin());
+    for(auto iter = values.begin(); iter != split; ++iter) CHECK(is_even(*iter));
+    for(auto iter = split; iter != values.end(); ++iter) CHECK(not is_even(*iter));
+
+    int raw[] = {2, 7, 4, 9, 6}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    int* cut = utl::partition(&raw[0], &raw[0] + 5, is_even); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    CHECK_EQUAL(3, cut - &raw[0]);
+    for(int* iter = &raw[0]; iter != cut; ++iter) CHECK(is_even(*iter)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+}
+
+TEST(Algorithm,MinMaxAccumulate)
+{
+    const utl::array<int,6> values{4, -2, 9, -2, 9, 0};
+    CHECK_EQUAL(1, utl::min_element(values) - values.begin());
+    CHECK_EQUAL(2, utl::max_element(values) - values.begin());
+    CHECK_EQUAL(18, utl::accumulate(values, 0));
+    CHECK_EQUAL(0, utl::accumulate(values, 1, [](int a, int b) { return a * b; }));
+    CHECK_EQUAL(18, utl::accumulate(values.data(), values.data() + values.size(), 0)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    const utl::span<const int> none{values.data(), 0};
+    CHECK(utl::min_element(none) == none.end());
+    CHECK_EQUAL(2, utl::min(2, 3));
+}
+
+TEST_GROUP(AlgorithmBenchmark) {};
+
+TEST(AlgorithmBenchmark,Sort)
+{
+    constexpr size_t iterations = 200;
+    static utl::array<int,4096> input{};
+    static utl::array<int,4096> values{};
+    utl::bench::lcg random{4};
+    for(auto& value : input) value = static_cast<int>(random());
+
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        values = input;
+        std::sort(values.begin(), values.end());
+        utl::bench::keep(values);
+    });
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        values = input;
+        utl::sort(values);
+        utl::bench::keep(values);
+    });
+    utl::bench::report("sort 4096 ints, against std::sort"_sv, baseline, candidate);
+    CHECK(is_sorted(values.begin(), values.end()));
+
+    static utl::array<int,2048> scratch{};
+    const auto stable_baseline = utl::bench::measure(iterations, [&](size_t) {
+        values = input;
+        std::stable_sort(values.begin(), values.end());
+        utl::bench::keep(values);
+    });
+    const auto stable_candidate = utl::bench::measure(iterations, [&](size_t) {
+        values = input;
+        utl::stable_sort(values, scratch);
+        utl::bench::keep(values);
+    });
+    utl::bench::report("stable sort 4096 ints, against std::stable_sort"_sv, stable_baseline, stable_candidate);
+    CHECK(is_sorted(values.begin(), values.end()));
+}
+
+TEST(AlgorithmBenchmark,SortingNetwork)
+{
+    constexpr size_t iterations = 20000;
+    constexpr size_t batches = 16;
+    static utl::array<utl::array<int,8>,batches> input{};
+    static utl::array<utl::array<int,8>,batches> values{};
+    utl::bench::lcg random{5};
+    for(auto& batch : input) {
+        for(auto& value : batch) value = static_cast<int>(random() % 1000);
+    }
+
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        values = input;
+        for(auto& batch : values) std::sort(batch.begin(), batch.end());
+        utl::bench::keep(values);
+    });
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        values = input;
+        for(auto& batch : values) utl::sort(batch);
+        utl::bench::keep(values);
+    });
+    utl::bench::report("sort 16 arrays of 8 ints, against std::sort"_sv, baseline, candidate);
+    for(auto& batch : values) CHECK(is_sorted(batch.begin(), batch.end()));
+}
@@ -0,0 +1,300 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/bitfield.hh>
+#include <utl/pal.hh>
+#include <utility>
+
+namespace {
+
+//With a type listed more than once, the index is that of the first
+//occurrence (it used to be the last).
+static_assert(utl::get_type_index_v<int, char, int, long, int> == 1);
+static_assert(utl::find_type_index_v<int, char, int, long, int> == 1);
+static_assert(utl::find_type_index_v<short, char, int> == 2);
+
+//A synthetic 64-field struct; field I is I % 3 + 1 bits wide.
+enum class wide_tag : uint8_t {};
+
+constexpr size_t n_wide_fields = 64;
+
+template <size_t I>
+using wide_field = utl::bitfield<static_cast<wide_tag>(I), utl::uintn_t<I % 3 + 1>>;
+
+template <size_t... Is>
+auto make_wide_struct(std::index_sequence<Is...>) -> utl::bitstruct<wide_field<Is>...>;
+
+using wide_t = decltype(make_wide_struct(std::make_index_sequence<n_wide_fields>{}));
+
+consteval size_t wide_offset(size_t index)
+{
+    size_t offset = 0;
+    for(size_t idx = 0; idx < index; idx++) offset += idx % 3 + 1;
+    return offset;
+}
+
+static_assert(wide_t::width() == wide_offset(n_wide_fields));
+static_assert(utl::get_field<static_cast<wide_tag>(0)>(wide_t{}).offset() == 0);
+static_assert(utl::get_field<static_cast<wide_tag>(1)>(wide_t{}).offset() == 1);
+static_assert(utl::get_field<static_cast<wide_tag>(37)>(wide_t{}).offset() == wide_offset(37));
+static_assert(utl::get_field<static_cast<wide_tag>(37)>(wide_t{}).width() == 2);
+static_assert(utl::get_field<static_cast<wide_tag>(63)>(wide_t{}).offset() == wide_offset(63));
+static_assert(utl::has_field<wide_t,static_cast<wide_tag>(63)>);
+static_assert(not utl::has_field<wide_t,static_cast<wide_tag>(64)>);
+
+enum class control_f : uint8_t { enable, mode, divider };
+enum class status_f : uint8_t { ready, error, count };
+
+using control_t = utl::bitstruct<
+    utl::bitfield<control_f::enable, utl::uintn_t<1>>,
+    utl::bitfield<control_f::mode, utl::uintn_t<3>>,
+    utl::bitfield<control_f::divider, utl::uintn_t<12>>
+>;
+
+using status_t = utl::bitstruct<
+    utl::bitfield<status_f::ready, utl::uintn_t<1>>,
+    utl::bitfield<status_f::error, utl::uintn_t<1>>,
+    utl::bitfield<status_f::count, utl::uintn_t<14>>
+>;
+
+struct peripheral {
+    control_t control{};
+    status_t status{};
+
+    constexpr auto registers() { return utl::tuple<control_t&,status_t&>{control, status}; }
+};
+
+static_assert(utl::pal::any_peripheral<peripheral>);
+
+enum class clock_f : uint8_t { source, enable };
+using clocks_t = utl::bitstruct<
+    utl::bitfield<clock_f::source, utl::uintn_t<2>>,
+    utl::bitfield<clock_f::enable, utl::uintn_t<1>>,
+    utl::bitfield<static_cast<clock_f>(2), utl::uintn_t<13>>
+>;
+
+//Counts loads (copies out of the register) and stores (copies into
+//it), and records which register each store went to.
+struct access_log {
+    size_t loads = 0;
+    size_t stores = 0;
+    utl::array<size_t,8> order{};
+};
+
+access_log accesses{};
+
+template <typename B, size_t Id>
+struct counted : B {
+    constexpr counted() = default;
+    counted(counted const& other) : B{other} { accesses.loads++; }
+    counted(counted&&) noexcept = default;
+    counted& operator=(counted const& other)
+    {
+        B::operator=(other);
+        accesses.order[accesses.stores++] = Id;
+        return *this;
+    }
+    counted& operator=(counted&&) noexcept = default;
+    ~counted() = default;
+};
+
+struct counted_peripheral {
+    counted<control_t,0> control{};
+    counted<status_t,1> status{};
+    counted<clocks_t,2> clock{};
+
+    constexpr auto registers()
+    {
+        return utl::tuple<counted<control_t,0>&,counted<status_t,1>&,counted<clocks_t,2>&>{control, status, clock};
+    }
+};
+
+//writes the clock before anything else
+struct clock_first_peripheral : counted_peripheral {
+    using apply_order_t = utl::pal::order::tags<clock_f>;
+};
+
+static_assert(utl::pal::any_peripheral<counted_peripheral>);
+
+//a status register that resets to ready, and a 24-bit register that
+//takes three bytes in a snapshot rather than four
+struct status_reset_t : status_t {
+    static constexpr value_t reset_value() { return 0x0001; }
+};
+
+enum class trim_f : uint8_t { value };
+using trim_t = utl::bitstruct<utl::bitfield<trim_f::value, utl::uintn_t<24>>>;
+
+struct sleepy_peripheral {
+    counted<control_t,0> control{};
+    counted<status_reset_t,1> status{};
+    counted<trim_t,2> trim{};
+
+    constexpr auto registers()
+    {
+        return utl::tuple<counted<control_t,0>&,counted<status_reset_t,1>&,counted<trim_t,2>&>{control, status, trim};
+    }
+};
+
+static_assert(utl::pal::snapshot_t<sleepy_peripheral>::size() == 7);
+static_assert(sizeof(utl::pal::snapshot_t<sleepy_peripheral>) == 7);
+
+} //anonymous namespace
+
+TEST_GROUP(Bitfield) {};
+
+TEST(Bitfield,WideStruct)
+{
+    wide_t value{};
+    value.value = 0;
+    auto field = utl::get_field<static_cast<wide_tag>(40)>(value);
+    field = 0b11;
+    CHECK_EQUAL(0b11u, static_cast<uint32_t>(field.value()));
+    CHECK(value.value == (utl::uintn_t<wide_t::width()>{0b11} << wide_offset(40)));
+    CHECK_EQUAL(0u, static_cast<uint32_t>(utl::get_field<static_cast<wide_tag>(39)>(value).value()));
+    CHECK_EQUAL(0u, static_cast<uint32_t>(utl::get_field<static_cast<wide_tag>(41)>(value).value()));
+}
+
+TEST_GROUP(Pal) {};
+
+TEST(Pal,GetRegister)
+{
+    peripheral p{};
+    CHECK(&utl::pal::get_register<control_f>(p) == &p.control);
+    CHECK(&utl::pal::get_register<status_f>(p) == &p.status);
+}
+
+TEST(Pal,GetField)
+{
+    peripheral p{};
+    p.status.value = 0;
+    utl::pal::get_field<status_f::count>(p) = 1234;
+    CHECK_EQUAL(1234u, static_cast<uint32_t>(utl::pal::read<status_f::count>(p)));
+    CHECK(p.status.value == (1234 << 2));
+    CHECK(p.control.value == 0);
+}
+
+TEST_GROUP(PalApply) {
+    void setup() override { accesses = {}; }
+};
+
+TEST(PalApply,OneLoadAndStorePerRegister)
+{
+    counted_peripheral p{};
+    const auto written = utl::pal::apply(p,
+        utl::pal::assign<control_f::enable>(1),
+        utl::pal::assign<status_f::count>(99),
+        utl::pal::assign<control_f::mode>(5),
+        utl::pal::assign<control_f::divider>(1000),
+        utl::pal::assign<status_f::error>(1)
+    );
+    CHECK_EQUAL(2u, accesses.loads);
+    CHECK_EQUAL(2u, accesses.stores);
+    CHECK_EQUAL(0u, accesses.order[0]);
+    CHECK_EQUAL(1u, accesses.order[1]);
+
+    CHECK_EQUAL(1u, static_cast<uint32_t>(utl::get_field<control_f::enable>(p.control).value()));
+    CHECK_EQUAL(5u, static_cast<uint32_t>(utl::get_field<control_f::mode>(p.control).value()));
+    CHECK_EQUAL(1000u, static_cast<uint32_t>(utl::get_field<control_f::divider>(p.control).value()));
+    CHECK_EQUAL(99u, static_cast<uint32_t>(utl::get_field<status_f::count>(p.status).value()));
+    CHECK_EQUAL(1u, static_cast<uint32_t>(utl::get_field<status_f::error>(p.status).value()));
+    CHECK(utl::get<0>(written).value == p.control.value);
+    CHECK(utl::get<1>(written).value == p.status.value);
+}
+
+TEST(PalApply,LaterOpsWin)
+{
+    counted_peripheral p{};
+    utl::pal::apply(p,
+        utl::pal::assign<control_f::mode>(1),
+        utl::pal::assign<control_f::mode>(6)
+    );
+    CHECK_EQUAL(6u, static_cast<uint32_t>(utl::get_field<control_f::mode>(p.control).value()));
+    CHECK_EQUAL(1u, accesses.stores);
+}
+
+TEST(PalApply,Order)
+{
+    counted_peripheral p{};
+    utl::pal::apply<utl::pal::order::declaration>(p,
+        utl::pal::assign<clock_f::enable>(1),
+        utl::pal::assign<status_f::ready>(1),
+        utl::pal::assign<control_f::enable>(1)
+    );
+    CHECK_EQUAL(3u, accesses.stores);
+    CHECK_EQUAL(0u, accesses.order[0]);
+    CHECK_EQUAL(1u, accesses.order[1]);
+    CHECK_EQUAL(2u, accesses.order[2]);
+
+    accesses = {};
+    utl::pal::apply<utl::pal::order::tags<status_f>>(p,
+        utl::pal::assign<clock_f::enable>(0),
+        utl::pal::assign<control_f::enable>(0),
+        utl::pal::assign<status_f::ready>(0)
+    );
+    CHECK_EQUAL(1u, accesses.order[0]);
+    CHECK_EQUAL(2u, accesses.order[1]);
+    CHECK_EQUAL(0u, accesses.order[2]);
+
+    clock_first_peripheral q{};
+    accesses = {};
+    utl::pal::apply(q,
+        utl::pal::assign<control_f::enable>(1),
+        utl::pal::assign<clock_f::source>(2)
+    );
+    CHECK_EQUAL(2u, accesses.order[0]);
+    CHECK_EQUAL(0u, accesses.order[1]);
+}
+
+TEST_GROUP(PalSnapshot) {
+    void setup() override { accesses = {}; }
+};
+
+TEST(PalSnapshot,RoundTrip)
+{
+    sleepy_peripheral p{};
+    p.control.value = 0xBEEF;
+    p.status.value = 0x1234;
+    p.trim.value = 0xABCDEF;
+
+    const auto saved = utl::pal::snapshot(p);
+    CHECK_EQUAL(3u, accesses.loads);
+    CHECK_EQUAL(0u, accesses.stores);
+    CHECK(saved.get<2>() == 0xABCDEF);
+
+    sleepy_peripheral q{};
+    CHECK_EQUAL(3u, utl::pal::restore(q, saved));
+    CHECK(q.control.value == 0xBEEF);
+    CHECK(q.status.value == 0x1234);
+    CHECK(q.trim.value == 0xABCDEF);
+    CHECK_EQUAL(0u, accesses.order[0]);
+    CHECK_EQUAL(1u, accesses.order[1]);
+    CHECK_EQUAL(2u, accesses.order[2]);
+}
+
+TEST(PalSnapshot,SkipsResetValues)
+{
+    sleepy_peripheral p{};
+    p.control.value = 0;
+    p.status.value = status_reset_t::reset_value();
+    p.trim.value = 7;
+    const auto saved = utl::pal::snapshot(p);
+
+    //control has no reset_value(), so it's written even though it's zero
+    sleepy_peripheral q{};
+    q.status.value = status_reset_t::reset_value();
+    accesses = {};
+    CHECK_EQUAL(2u, utl::pal::restore(q, saved));
+    CHECK_EQUAL(0u, accesses.order[0]);
+    CHECK_EQUAL(2u, accesses.order[1]);
+    CHECK(q.trim.value == 7);
+}
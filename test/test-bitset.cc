@@ -0,0 +1,158 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/bitset.hh>
+#include <utl/ranges.hh>
+#include <utl/ranges/adaptors.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+using blocks_t = utl::bitset_n<200>;
+
+constexpr auto make_blocks()
+{
+    blocks_t blocks{};
+    blocks.set(3).set(64).set(199);
+    return blocks;
+}
+
+static_assert(make_blocks().count() == 3);
+static_assert(make_blocks().find_first_set() == 3);
+static_assert(make_blocks().find_next_set(4) == 64);
+static_assert(make_blocks().find_next_set(200) == blocks_t::npos);
+static_assert(utl::bitset_n<64>::n_words * sizeof(uintptr_t) == 8);
+
+//the set bits are a range, so the adaptors apply
+static_assert(utl::ranges::iterable<blocks_t>);
+
+constexpr size_t sum_of_doubled(blocks_t const& blocks)
+{
+    size_t total = 0;
+    for(auto value : blocks | utl::ranges::transform([](size_t idx) { return idx * 2; })) total += value;
+    return total;
+}
+static_assert(sum_of_doubled(make_blocks()) == 2 * (3 + 64 + 199));
+
+} //anonymous namespace
+
+TEST_GROUP(BitsetN) {};
+
+TEST(BitsetN,SetClearTest)
+{
+    blocks_t blocks{};
+    CHECK(blocks.none());
+    blocks.set(0).set(63).set(64).set(199);
+    CHECK(blocks.test(0));
+    CHECK(blocks.test(63));
+    CHECK(blocks.test(64));
+    CHECK(blocks.test(199));
+    CHECK(not blocks.test(1));
+    CHECK_EQUAL(4u, blocks.count());
+
+    blocks.clear(63).flip(64).flip(65).set(0, false);
+    CHECK(not blocks.test(0));
+    CHECK(not blocks.test(63));
+    CHECK(not blocks.test(64));
+    CHECK(blocks.test(65));
+    CHECK_EQUAL(2u, blocks.count());
+}
+
+TEST(BitsetN,SetAll)
+{
+    blocks_t blocks{};
+    blocks.set_all();
+    CHECK(blocks.all());
+    CHECK_EQUAL(200u, blocks.count());
+    CHECK_EQUAL(blocks_t::npos, blocks.find_first_clear());
+
+    //nothing past the last bit is set, even after inverting
+    const auto inverted = ~blocks_t{};
+    CHECK(inverted == blocks);
+    CHECK_EQUAL(200u, inverted.count());
+
+    blocks.clear(150);
+    CHECK(not blocks.all());
+    CHECK_EQUAL(150u, blocks.find_first_clear());
+    blocks.clear_all();
+    CHECK(blocks.none());
+}
+
+TEST(BitsetN,Find)
+{
+    blocks_t blocks{};
+    CHECK_EQUAL(blocks_t::npos, blocks.find_first_set());
+    blocks.set(70).set(130);
+    CHECK_EQUAL(70u, blocks.find_first_set());
+    CHECK_EQUAL(70u, blocks.find_next_set(70));
+    CHECK_EQUAL(130u, blocks.find_next_set(71));
+    CHECK_EQUAL(blocks_t::npos, blocks.find_next_set(131));
+    CHECK_EQUAL(0u, blocks.find_first_clear());
+    CHECK_EQUAL(71u, blocks.find_next_clear(70));
+}
+
+TEST(BitsetN,Bulk)
+{
+    blocks_t lhs{};
+    blocks_t rhs{};
+    lhs.set(1).set(100).set(150);
+    rhs.set(100).set(150).set(180);
+
+    const auto both = lhs & rhs;
+    CHECK_EQUAL(2u, both.count());
+    CHECK(both.test(100) and both.test(150));
+
+    const auto either = lhs | rhs;
+    CHECK_EQUAL(4u, either.count());
+
+    const auto one = lhs ^ rhs;
+    CHECK_EQUAL(2u, one.count());
+    CHECK(one.test(1) and one.test(180));
+
+    lhs ^= one;
+    CHECK(lhs == rhs);
+}
+
+TEST(BitsetN,Iterate)
+{
+    blocks_t blocks{};
+    const size_t expected[] = {0, 5, 63, 64, 127, 128, 199};
+    for(auto idx : expected) blocks.set(idx);
+
+    size_t seen = 0;
+    for(auto idx : blocks) {
+        CHECK_EQUAL(expected[seen], idx); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        seen++;
+    }
+    CHECK_EQUAL(7u, seen);
+
+    size_t none = 0;
+    for([[maybe_unused]] auto idx : blocks_t{}) none++;
+    CHECK_EQUAL(0u, none);
+}
+
+TEST(BitsetN,Enumerate)
+{
+    size_t expected = 0;
+    for(auto [position, idx] : utl::ranges::enumerate(make_blocks())) {
+        CHECK_EQUAL(expected, position);
+        CHECK(make_blocks().test(idx));
+        expected++;
+    }
+    CHECK_EQUAL(3u, expected);
+
+    const auto blocks = make_blocks();
+    auto iter = blocks.begin();
+    CHECK_EQUAL(3u, *iter++);
+    CHECK_EQUAL(64u, *iter);
+}
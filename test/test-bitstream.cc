@@ -0,0 +1,188 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/bitfield.hh>
+#include <utl/bitstream.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+//a 20-bit sample header
+enum class sample_f : uint8_t { channel, value, flags };
+using sample_t = utl::bitstruct<
+    utl::bitfield<sample_f::channel, utl::uintn_t<5>>,
+    utl::bitfield<sample_f::value, utl::uintn_t<12>>,
+    utl::bitfield<sample_f::flags, utl::uintn_t<3>>
+>;
+
+//wider than one accumulator
+enum class wide_f : uint8_t { low, high };
+using wide_t = utl::bitstruct<
+    utl::bitfield<wide_f::low, utl::uintn_t<60>>,
+    utl::bitfield<wide_f::high, utl::uintn_t<40>>
+>;
+
+sample_t make_sample(uint32_t n)
+{
+    sample_t sample{};
+    utl::get_field<sample_f::channel>(sample) = static_cast<utl::uintn_t<5>>(n % 32);
+    utl::get_field<sample_f::value>(sample) = static_cast<utl::uintn_t<12>>((n * 37) % 4096);
+    utl::get_field<sample_f::flags>(sample) = static_cast<utl::uintn_t<3>>(n % 8);
+    return sample;
+}
+
+//The approach bitstream_writer replaces: a read-modify-write of the
+//output for every record. Needs eight bytes of slack at the end.
+void pack_in_place(utl::span<uint8_t> out, utl::span<const sample_t> samples)
+{
+    constexpr size_t width = sample_t::width();
+    constexpr uint64_t mask = (uint64_t{1} << width) - 1;
+    for(size_t idx = 0; idx < samples.size(); idx++) {
+        const auto position = idx * width;
+        uint64_t word = 0;
+        __builtin_memcpy(&word, out.data() + position / 8, sizeof(word)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        const auto shift = position % 8;
+        word = (word & ~(mask << shift)) | (static_cast<uint64_t>(samples[idx].value) << shift);
+        __builtin_memcpy(out.data() + position / 8, &word, sizeof(word)); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+}
+
+} //anonymous namespace
+
+TEST_GROUP(Bitstream) {};
+
+TEST(Bitstream,Bits)
+{
+    utl::array<uint8_t,16> buffer{};
+    utl::bitstream_writer writer{buffer};
+    writer.write(0b101, 3);
+    writer.write(0x1F, 5);
+    writer.write(0xABC, 12);
+    writer.write(0x0123'4567'89AB'CDEF, 64);
+    CHECK_EQUAL(84u, writer.bits());
+    auto res = writer.finish();
+    CHECK(res.has_value());
+    CHECK_EQUAL(11u, res.value());
+    CHECK_EQUAL(0xFDu, buffer[0]);
+    CHECK_EQUAL(0xBCu, buffer[1]);
+
+    utl::bitstream_reader reader{utl::span<const uint8_t>{buffer.data(), 11}};
+    CHECK_EQUAL(0b101u, reader.read(3));
+    CHECK_EQUAL(0x1Fu, reader.read(5));
+    CHECK_EQUAL(0xABCu, reader.read(12));
+    CHECK(reader.read(64) == 0x0123'4567'89AB'CDEF);
+    CHECK_EQUAL(4u, reader.remaining());
+    CHECK(not reader.overflowed());
+}
+
+TEST(Bitstream,RoundTripRecords)
+{
+    utl::array<sample_t,100> samples{};
+    for(uint32_t idx = 0; idx < samples.size(); idx++) samples[idx] = make_sample(idx);
+
+    utl::array<uint8_t,250> buffer{};
+    utl::bitstream_writer writer{buffer};
+    writer.write_all(samples);
+    auto res = writer.finish();
+    CHECK(res.has_value());
+    CHECK_EQUAL(250u, res.value());
+
+    utl::array<sample_t,100> unpacked{};
+    utl::bitstream_reader reader{buffer};
+    reader.read_all(unpacked);
+    CHECK(not reader.overflowed());
+    for(size_t idx = 0; idx < samples.size(); idx++) {
+        CHECK(samples[idx].value == unpacked[idx].value);
+    }
+
+    //the packing is the same as a read-modify-write per record
+    utl::array<uint8_t,258> reference{};
+    pack_in_place(reference, samples);
+    CHECK_EQUAL(0, __builtin_memcmp(buffer.data(), reference.data(), buffer.size()));
+}
+
+TEST(Bitstream,WideRecords)
+{
+    utl::array<wide_t,3> records{};
+    for(size_t idx = 0; idx < records.size(); idx++) {
+        utl::get_field<wide_f::low>(records[idx]) = static_cast<utl::uintn_t<60>>(0x0ABC'DEF0'1234'5678 + idx);
+        utl::get_field<wide_f::high>(records[idx]) = static_cast<utl::uintn_t<40>>(0xFF'0000'0001 * (idx + 1));
+    }
+
+    utl::array<uint8_t,38> buffer{};
+    utl::bitstream_writer writer{buffer};
+    writer.write(1, 1); //misalign everything after
+    writer.write_all(records);
+    CHECK(writer.finish().has_value());
+
+    utl::bitstream_reader reader{buffer};
+    CHECK_EQUAL(1u, reader.read(1));
+    for(auto const& record : records) {
+        CHECK(reader.read<wide_t>().value == record.value);
+    }
+}
+
+TEST(Bitstream,Overflow)
+{
+    utl::array<uint8_t,2> buffer{};
+    utl::bitstream_writer writer{buffer};
+    writer.write(0xFFF, 12);
+    writer.write(0xFF, 8);
+    CHECK(writer.overflowed());
+    auto res = writer.finish();
+    CHECK(not res.has_value());
+    CHECK_EQUAL(0xFFu, buffer[0]);
+    CHECK_EQUAL(0x0Fu, buffer[1]);
+
+    utl::bitstream_reader reader{buffer};
+    reader.read(12);
+    CHECK_EQUAL(0u, reader.read(8));
+    CHECK(reader.overflowed());
+}
+
+TEST_GROUP(BitstreamBenchmark) {};
+
+TEST(BitstreamBenchmark,Pack)
+{
+    constexpr size_t n_samples = 4096;
+    constexpr size_t n_bytes = n_samples * sample_t::width() / 8;
+    constexpr size_t iterations = 200;
+
+    static utl::array<sample_t,n_samples> samples{};
+    for(uint32_t idx = 0; idx < n_samples; idx++) samples[idx] = make_sample(idx);
+    static utl::array<uint8_t,n_bytes + 8> in_place{};
+    static utl::array<uint8_t,n_bytes> streamed{};
+
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        pack_in_place(in_place, samples);
+        utl::bench::keep(in_place);
+    });
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        utl::bitstream_writer writer{streamed};
+        writer.write_all(samples);
+        utl::bench::keep(writer.finish());
+    });
+    utl::bench::report("bitstream pack 4096 x 20-bit records"_sv, baseline, candidate);
+    CHECK_EQUAL(0, __builtin_memcmp(in_place.data(), streamed.data(), n_bytes));
+
+    static utl::array<sample_t,n_samples> unpacked{};
+    const auto unpack = utl::bench::measure(iterations, [&](size_t) {
+        utl::bitstream_reader reader{streamed};
+        reader.read_all(unpacked);
+        utl::bench::keep(unpacked);
+    });
+    utl::bench::report("bitstream unpack 4096 x 20-bit records"_sv, unpack);
+    CHECK(unpacked[n_samples - 1].value == samples[n_samples - 1].value);
+}
@@ -0,0 +1,123 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/bitstruct-view.hh>
+
+namespace {
+
+//a USB setup packet; multi-byte fields are little endian on the wire
+enum class setup_f : uint8_t { recipient, type, direction, request, value, index, length };
+
+template <std::endian E, typename Byte = const uint8_t>
+using setup_view_t = utl::basic_bitstruct_view<Byte, E,
+    utl::bitfield<setup_f::recipient, utl::uintn_t<5>>,
+    utl::bitfield<setup_f::type, utl::uintn_t<2>>,
+    utl::bitfield<setup_f::direction, utl::uintn_t<1>>,
+    utl::bitfield<setup_f::request, utl::uintn_t<8>>,
+    utl::bitfield<setup_f::value, utl::uintn_t<16>>,
+    utl::bitfield<setup_f::index, utl::uintn_t<16>>,
+    utl::bitfield<setup_f::length, utl::uintn_t<16>>
+>;
+
+using setup_t = setup_view_t<std::endian::little>;
+
+//GET_DESCRIPTOR(device), 64 bytes
+constexpr utl::array<const uint8_t,8> get_descriptor{{0x80, 0x06, 0x00, 0x01, 0x00, 0x00, 0x40, 0x00}};
+
+static_assert(setup_t::size() == 8);
+static_assert(utl::has_field<setup_t,setup_f::length>);
+static_assert(utl::get_field<setup_f::direction>(setup_t{get_descriptor}).value() == 1);
+static_assert(utl::get_field<setup_f::type>(setup_t{get_descriptor}).value() == 0);
+static_assert(utl::get_field<setup_f::request>(setup_t{get_descriptor}).value() == 0x06);
+static_assert(utl::get_field<setup_f::value>(setup_t{get_descriptor}).value() == 0x0100);
+static_assert(utl::get_field<setup_f::length>(setup_t{get_descriptor}).value() == 64);
+
+//a big endian sensor frame with fields that straddle bytes
+enum class sample_f : uint8_t { y, x, status };
+
+template <typename Byte>
+using sample_view_t = utl::basic_bitstruct_view<Byte, std::endian::big,
+    utl::bitfield<sample_f::y, utl::uintn_t<10>>,
+    utl::bitfield<sample_f::x, utl::uintn_t<10>>,
+    utl::bitfield<sample_f::status, utl::uintn_t<4>>
+>;
+
+constexpr uint32_t sample_word = 0xABCDEF;
+constexpr utl::array<const uint8_t,3> sample{{0xAB, 0xCD, 0xEF}};
+
+static_assert(utl::get_field<sample_f::y>(sample_view_t<const uint8_t>{sample}).value() == (sample_word & 0x3FF));
+static_assert(utl::get_field<sample_f::x>(sample_view_t<const uint8_t>{sample}).value() == ((sample_word >> 10) & 0x3FF));
+static_assert(utl::get_field<sample_f::status>(sample_view_t<const uint8_t>{sample}).value() == 0xA);
+
+} //anonymous namespace
+
+TEST_GROUP(BitstructView) {};
+
+TEST(BitstructView,ReadLittleEndian)
+{
+    const setup_t setup{get_descriptor};
+    CHECK_EQUAL(0u, static_cast<uint32_t>(utl::get_field<setup_f::recipient>(setup).value()));
+    CHECK_EQUAL(1u, static_cast<uint32_t>(utl::get_field<setup_f::direction>(setup).value()));
+    CHECK_EQUAL(0x0100u, static_cast<uint32_t>(utl::get_field<setup_f::value>(setup).value()));
+    CHECK_EQUAL(0u, static_cast<uint32_t>(utl::get_field<setup_f::index>(setup).value()));
+    CHECK_EQUAL(64u, static_cast<uint32_t>(utl::get_field<setup_f::length>(setup).value()));
+}
+
+TEST(BitstructView,SameLayoutAsBitstruct)
+{
+    //the same fields, byte swapped, read through a big endian view
+    const utl::array<const uint8_t,8> swapped{{0x00, 0x40, 0x00, 0x00, 0x01, 0x00, 0x06, 0x80}};
+    const setup_view_t<std::endian::big> setup{swapped};
+    CHECK_EQUAL(1u, static_cast<uint32_t>(utl::get_field<setup_f::direction>(setup).value()));
+    CHECK_EQUAL(0x06u, static_cast<uint32_t>(utl::get_field<setup_f::request>(setup).value()));
+    CHECK_EQUAL(0x0100u, static_cast<uint32_t>(utl::get_field<setup_f::value>(setup).value()));
+    CHECK_EQUAL(64u, static_cast<uint32_t>(utl::get_field<setup_f::length>(setup).value()));
+}
+
+TEST(BitstructView,WriteOnlyTouchesField)
+{
+    utl::array<uint8_t,3> bytes{{0xAB, 0xCD, 0xEF}};
+    const sample_view_t<uint8_t> view{bytes};
+
+    //x occupies bits 10..19 of the value, i.e. parts of all three bytes
+    utl::get_field<sample_f::x>(view) = 0x155;
+    const uint32_t expected = (sample_word & ~(0x3FFu << 10)) | (0x155u << 10);
+    CHECK_EQUAL((expected >> 16) & 0xFF, bytes[0]);
+    CHECK_EQUAL((expected >> 8) & 0xFF, bytes[1]);
+    CHECK_EQUAL(expected & 0xFF, bytes[2]);
+    CHECK_EQUAL(0x155u, static_cast<uint32_t>(utl::get_field<sample_f::x>(view).value()));
+    CHECK_EQUAL(0xAu, static_cast<uint32_t>(utl::get_field<sample_f::status>(view).value()));
+    CHECK_EQUAL(sample_word & 0x3FF, static_cast<uint32_t>(utl::get_field<sample_f::y>(view).value()));
+
+    //a field confined to one byte leaves its neighbours alone
+    utl::array<uint8_t,8> setup{};
+    const setup_view_t<std::endian::little,uint8_t> writable{setup};
+    utl::get_field<setup_f::request>(writable) = 0x09;
+    utl::get_field<setup_f::length>(writable) = 0x1234;
+    CHECK_EQUAL(0u, setup[0]);
+    CHECK_EQUAL(0x09u, setup[1]);
+    CHECK_EQUAL(0u, setup[5]);
+    CHECK_EQUAL(0x34u, setup[6]);
+    CHECK_EQUAL(0x12u, setup[7]);
+}
+
+TEST(BitstructView,Overlay)
+{
+    const utl::array<const uint8_t,4> runt{{0x80, 0x06, 0x00, 0x01}};
+    auto res = setup_t::overlay(runt);
+    CHECK(not res.has_value());
+
+    auto ok = setup_t::overlay(get_descriptor);
+    CHECK(ok.has_value());
+    CHECK_EQUAL(0x06u, static_cast<uint32_t>(utl::get_field<setup_f::request>(ok.value()).value()));
+}
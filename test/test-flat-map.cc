@@ -0,0 +1,155 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/ranges.hh>
+#include <utl/flat-map.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+constexpr utl::flat_map<int,int,4> squares{{3, 9}, {1, 1}, {2, 4}};
+
+static_assert(squares.size() == 3);
+static_assert(squares.contains(2));
+static_assert(not squares.contains(4));
+static_assert(*squares.find(3) == 9);
+static_assert(squares.keys()[0] == 1 and squares.keys()[2] == 3);
+static_assert(utl::ranges::iterable<utl::flat_map<int,int,4>>);
+
+//later duplicates win, and don't count against the capacity; a third
+//distinct key here would fail to compile
+constexpr utl::flat_map<int,int,2> deduplicated{{1, 1}, {1, 2}, {5, 5}, {5, 6}};
+static_assert(deduplicated.size() == 2 and *deduplicated.find(1) == 2 and *deduplicated.find(5) == 6);
+
+struct pair_entry {
+    uint32_t key;
+    uint32_t value;
+};
+
+} //anonymous namespace
+
+TEST_GROUP(FlatMap) {};
+
+TEST(FlatMap,InsertFindErase)
+{
+    utl::flat_map<int,int,4> map{};
+    CHECK(map.empty());
+    CHECK(map.find(1) == nullptr);
+
+    CHECK(map.insert(20, 200).has_value());
+    CHECK(map.insert(10, 100).has_value());
+    CHECK(map.insert(30, 300).has_value());
+    CHECK_EQUAL(3u, map.size());
+
+    //insert leaves an existing value alone; insert_or_assign replaces it
+    const auto kept = map.insert(10, 111);
+    CHECK_EQUAL(100, kept.value());
+    const auto replaced = map.insert_or_assign(10, 111);
+    CHECK_EQUAL(111, replaced.value());
+
+    CHECK(map.insert(40, 400).has_value());
+    CHECK(map.full());
+    const auto overflow = map.insert(50, 500);
+    CHECK(not overflow.has_value());
+    CHECK_EQUAL(static_cast<int32_t>(utl::errc::out_of_bounds), overflow.error().value());
+
+    const int expected_keys[] = {10, 20, 30, 40};
+    const int expected_values[] = {111, 200, 300, 400};
+    size_t idx = 0;
+    for(auto entry : map) {
+        CHECK_EQUAL(expected_keys[idx], utl::get<0>(entry)); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        CHECK_EQUAL(expected_values[idx], utl::get<1>(entry)); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        utl::get<1>(entry)++;
+        idx++;
+    }
+    CHECK_EQUAL(4u, idx);
+    CHECK_EQUAL(201, *map.find(20));
+
+    CHECK(map.erase(20));
+    CHECK(not map.erase(20));
+    CHECK(not map.contains(20));
+    CHECK_EQUAL(3u, map.size());
+    CHECK_EQUAL(10, map.keys()[0]);
+    CHECK_EQUAL(30, map.keys()[1]);
+    CHECK_EQUAL(301, map.values()[1]);
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(not map.contains(10));
+}
+
+TEST(FlatMap,MatchesLinearSearch)
+{
+    utl::flat_map<uint32_t,uint32_t,64> map{};
+    for(uint32_t idx = 0; idx < 64; idx++) CHECK(map.insert((idx * 37) % 101, idx).has_value());
+    CHECK_EQUAL(64u, map.size());
+    for(uint32_t key = 0; key < 101; key++) {
+        bool present = false;
+        for(uint32_t idx = 0; idx < 64; idx++) present = present or (idx * 37) % 101 == key;
+        CHECK_EQUAL(present, map.contains(key));
+    }
+    for(size_t idx = 1; idx < map.size(); idx++) CHECK(map.keys()[idx - 1] < map.keys()[idx]);
+}
+
+TEST(FlatMap,RuntimeListDropsExtras)
+{
+    //built at runtime, entries past the capacity are dropped
+    int key = 3;
+    const utl::flat_map<int,int,2> map{{1, 1}, {2, 2}, {key, 3}};
+    CHECK_EQUAL(2u, map.size());
+    CHECK(not map.contains(key));
+}
+
+TEST_GROUP(FlatMapBenchmark) {};
+
+TEST(FlatMapBenchmark,Lookup)
+{
+    constexpr size_t iterations = 2000;
+    constexpr uint32_t n_keys = 64;
+    //sparse keys, as handles and config IDs are
+    static utl::array<pair_entry,n_keys> table{};
+    static utl::flat_map<uint32_t,uint32_t,n_keys> map{};
+    for(uint32_t idx = 0; idx < n_keys; idx++) {
+        table[idx] = {idx * 2654435761u >> 16, idx};
+        CHECK(map.insert(table[idx].key, idx).has_value());
+    }
+    static utl::array<uint32_t,1024> queries{};
+    utl::bench::lcg random{1};
+    for(auto& query : queries) query = table[random() >> 18].key;
+
+    uint32_t expected = 0;
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        uint32_t sum = 0;
+        for(auto query : queries) {
+            for(auto const& entry : table) {
+                if(entry.key == query) {
+                    sum += entry.value;
+                    break;
+                }
+            }
+        }
+        expected = sum;
+        utl::bench::keep(sum);
+    });
+    uint32_t found = 0;
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        uint32_t sum = 0;
+        for(auto query : queries) sum += *map.find(query);
+        found = sum;
+        utl::bench::keep(sum);
+    });
+    utl::bench::report("look up 1024 keys among 64"_sv, baseline, candidate);
+    CHECK_EQUAL(expected, found);
+}
@@ -0,0 +1,130 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/hash.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+static_assert(utl::fnv1a32(""_sv) == 0x811C'9DC5);
+static_assert(utl::fnv1a32("a"_sv) == 0xE40C'292C);
+static_assert(utl::fnv1a32("foobar"_sv) == 0xBF9C'F968);
+static_assert(utl::fnv1a64("a"_sv) == 0xAF63'DC4C'8601'EC8C);
+static_assert(utl::fnv1a64("foobar"_sv) == 0x8594'4171'F739'67E8);
+
+static_assert(utl::xxhash32(""_sv) == 0x02CC'5D05);
+static_assert(utl::xxhash32("a"_sv) == 0x550D'7456);
+static_assert(utl::xxhash32("abc"_sv) == 0x32D1'53FF);
+static_assert(utl::xxhash32("abc"_sv, 0x9747'B28C) == 0x4D4C'B222);
+static_assert(utl::xxhash32("Nobody inspects the spammish repetition"_sv) == 0xE229'3B2F);
+
+constexpr utl::string_switch commands{
+    "help", "reset", "status", "version", "reboot", "log", "level", "set", "get", "erase",
+    "write", "read", "dump", "trace", "calibrate", "sleep", "wake", "led", "adc", "dac",
+    "pwm", "gpio", "i2c", "spi"
+};
+
+static_assert(commands.size() == 24);
+static_assert(commands.find("help") == 0);
+static_assert(commands.find("spi") == 23);
+static_assert(commands.find("nope") == utl::npos);
+
+//the chain of comparisons string_switch replaces
+size_t compare_chain(utl::string_view cmd)
+{
+    size_t idx = 0;
+    for(auto keyword : {"help"_sv, "reset"_sv, "status"_sv, "version"_sv, "reboot"_sv, "log"_sv,
+            "level"_sv, "set"_sv, "get"_sv, "erase"_sv, "write"_sv, "read"_sv, "dump"_sv, "trace"_sv,
+            "calibrate"_sv, "sleep"_sv, "wake"_sv, "led"_sv, "adc"_sv, "dac"_sv, "pwm"_sv, "gpio"_sv,
+            "i2c"_sv, "spi"_sv}) {
+        if(cmd == keyword) return idx;
+        idx++;
+    }
+    return utl::npos;
+}
+
+} //anonymous namespace
+
+TEST_GROUP(Hash) {};
+
+TEST(Hash,RuntimeMatchesConstant)
+{
+    //the same functions, evaluated at runtime
+    volatile size_t length = 39;
+    const utl::string_view text{"Nobody inspects the spammish repetition", length};
+    CHECK_EQUAL(0xE229'3B2Fu, utl::xxhash32(text));
+    CHECK_EQUAL(utl::fnv1a32("Nobody inspects the spammish repetition"_sv), utl::fnv1a32(text));
+}
+
+TEST(Hash,StringSwitch)
+{
+    for(size_t idx = 0; idx < commands.size(); idx++) {
+        CHECK_EQUAL(idx, commands.find(commands.keyword_at(idx)));
+    }
+    CHECK_EQUAL(utl::npos, commands.find(""_sv));
+    CHECK_EQUAL(utl::npos, commands.find("hel"_sv));
+    CHECK_EQUAL(utl::npos, commands.find("helpp"_sv));
+    CHECK(commands.contains("gpio"_sv));
+    CHECK(not commands.contains("GPIO"_sv));
+
+    const auto dispatch = [](utl::string_view cmd) {
+        switch(commands.find(cmd)) {
+            case commands.index("reset"): return 1;
+            case commands.index("status"): return 2;
+            case utl::npos: return -1;
+            default: return 0;
+        }
+    };
+    CHECK_EQUAL(1, dispatch("reset"_sv));
+    CHECK_EQUAL(2, dispatch("status"_sv));
+    CHECK_EQUAL(0, dispatch("help"_sv));
+    CHECK_EQUAL(-1, dispatch("restart"_sv));
+}
+
+TEST(Hash,SmallSwitch)
+{
+    constexpr utl::string_switch one{"only"};
+    CHECK_EQUAL(0u, one.find("only"_sv));
+    CHECK_EQUAL(utl::npos, one.find("other"_sv));
+
+    constexpr utl::string_switch two{"on"_sv, "off"_sv};
+    CHECK_EQUAL(1u, two.find("off"_sv));
+}
+
+TEST_GROUP(HashBenchmark) {};
+
+TEST(HashBenchmark,StringSwitch)
+{
+    constexpr size_t iterations = 20000;
+    //a mix of early, late and unknown commands
+    constexpr utl::string_view inputs[] = {"help"_sv, "spi"_sv, "gpio"_sv, "calibrate"_sv, //NOLINT(cppcoreguidelines-avoid-c-arrays)
+        "frobnicate"_sv, "dac"_sv, "wake"_sv, "status"_sv};
+
+    size_t chain_total = 0;
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        size_t total = 0;
+        for(auto input : inputs) total += compare_chain(input);
+        utl::bench::keep(total);
+        chain_total = total;
+    });
+    size_t switch_total = 0;
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        size_t total = 0;
+        for(auto input : inputs) total += commands.find(input);
+        utl::bench::keep(total);
+        switch_total = total;
+    });
+    utl::bench::report("dispatch 8 commands among 24 keywords"_sv, baseline, candidate);
+    CHECK_EQUAL(chain_total, switch_total);
+}
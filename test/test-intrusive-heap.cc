@@ -0,0 +1,159 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/intrusive-heap.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+struct timer : utl::heap_hook {
+    uint32_t deadline = 0;
+};
+
+//keyed on a different member, with its hook as a member
+struct job {
+    int priority = 0;
+    utl::heap_hook link;
+};
+
+struct greater {
+    constexpr bool operator()(int a, int b) const { return a > b; }
+};
+
+static_assert(std::is_same_v<utl::intrusive_heap<timer,&timer::deadline>::key_t, uint32_t>);
+
+//pops everything, checking that it comes out in order
+template <typename H>
+bool drains_in_order(H& heap, size_t expected_size)
+{
+    size_t count = 0;
+    uint32_t previous = 0;
+    while(not heap.empty()) {
+        const uint32_t deadline = heap.top().deadline;
+        if(deadline < previous) return false;
+        previous = deadline;
+        heap.pop();
+        count++;
+    }
+    return count == expected_size;
+}
+
+} //anonymous namespace
+
+TEST_GROUP(IntrusiveHeap) {};
+
+TEST(IntrusiveHeap,PushPop)
+{
+    utl::array<timer,5> timers{};
+    const uint32_t deadlines[] = {50, 10, 40, 20, 30};
+    utl::intrusive_heap<timer,&timer::deadline> heap{};
+    CHECK(heap.empty());
+    for(size_t idx = 0; idx < timers.size(); idx++) {
+        timers[idx].deadline = deadlines[idx]; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        heap.push(timers[idx]);
+    }
+    CHECK_EQUAL(5u, heap.size());
+    CHECK(timers[3].is_linked());
+    CHECK_EQUAL(10u, heap.top().deadline);
+
+    heap.pop();
+    CHECK(not timers[1].is_linked());
+    CHECK_EQUAL(20u, heap.top().deadline);
+    CHECK(drains_in_order(heap, 4));
+    for(auto const& t : timers) CHECK(not t.is_linked());
+}
+
+TEST(IntrusiveHeap,EraseAndUpdate)
+{
+    utl::array<timer,8> timers{};
+    utl::intrusive_heap<timer,&timer::deadline> heap{};
+    for(size_t idx = 0; idx < timers.size(); idx++) {
+        timers[idx].deadline = static_cast<uint32_t>(100 + 10 * idx);
+        heap.push(timers[idx]);
+    }
+
+    //cancelled
+    heap.erase(timers[0]);
+    heap.erase(timers[5]);
+    CHECK(not timers[0].is_linked());
+    CHECK_EQUAL(6u, heap.size());
+    CHECK_EQUAL(110u, heap.top().deadline);
+
+    //rescheduled earlier
+    heap.decrease_key(timers[7], 5);
+    CHECK(&heap.top() == &timers[7]);
+
+    //and later
+    timers[7].deadline = 1000;
+    heap.update(timers[7]);
+    CHECK(&heap.top() == &timers[1]);
+
+    heap.push(timers[0]);
+    CHECK(drains_in_order(heap, 7));
+}
+
+TEST(IntrusiveHeap,Random)
+{
+    //a mix of every operation, checked against a scan for the minimum
+    utl::array<timer,64> timers{};
+    utl::intrusive_heap<timer,&timer::deadline> heap{};
+    utl::bench::lcg random{11};
+    for(size_t round = 0; round < 4000; round++) {
+        timer& t = timers[random() % timers.size()];
+        const uint32_t choice = random() % 4;
+        if(not t.is_linked()) {
+            t.deadline = random() % 1000;
+            heap.push(t);
+        } else if(choice == 0) {
+            heap.erase(t);
+        } else if(choice == 1) {
+            heap.decrease_key(t, t.deadline / 2);
+        } else if(choice == 2) {
+            t.deadline = random() % 1000;
+            heap.update(t);
+        } else {
+            heap.pop();
+        }
+
+        size_t linked = 0;
+        uint32_t minimum = 0xFFFF'FFFF;
+        for(auto const& each : timers) {
+            if(not each.is_linked()) continue;
+            linked++;
+            minimum = utl::min(minimum, each.deadline);
+        }
+        CHECK_EQUAL(linked, heap.size());
+        if(linked > 0) CHECK_EQUAL(minimum, heap.top().deadline);
+    }
+    CHECK(drains_in_order(heap, heap.size()));
+}
+
+TEST(IntrusiveHeap,MemberHookAndComparison)
+{
+    utl::array<job,4> jobs{};
+    const int priorities[] = {2, 7, 1, 5};
+    utl::intrusive_heap<job,&job::priority,greater,&job::link> heap{};
+    for(size_t idx = 0; idx < jobs.size(); idx++) {
+        jobs[idx].priority = priorities[idx]; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        heap.push(jobs[idx]);
+    }
+    CHECK_EQUAL(7, heap.top().priority);
+    CHECK(jobs[1].link.is_linked());
+    heap.pop();
+    CHECK_EQUAL(5, heap.top().priority);
+    heap.clear();
+    CHECK(heap.empty());
+    CHECK(not jobs[3].link.is_linked());
+}
@@ -0,0 +1,172 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/ranges.hh>
+#include <utl/intrusive-list.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+struct request : utl::list_hook {
+    int id = 0;
+};
+
+//in two lists at once, through member hooks
+struct buffer {
+    int id = 0;
+    utl::list_hook pending;
+    utl::slist_hook free;
+};
+
+//stands in for the self type that utl::mix gives a mixin
+struct driver_base {
+    int id = 0;
+};
+using linked_driver = utl::list_mixin<driver_base>;
+
+static_assert(utl::ranges::iterable<utl::intrusive_list<request>>);
+static_assert(utl::ranges::iterable<utl::intrusive_slist<buffer,&buffer::free>>);
+static_assert(sizeof(utl::slist_hook) == sizeof(void*));
+
+template <typename L>
+bool ids_are(L const& list, std::initializer_list<int> ids)
+{
+    if(list.size() != ids.size()) return false;
+    const int* expected = ids.begin();
+    for(auto const& element : list) {
+        if(element.id != *expected++) return false; //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    }
+    return true;
+}
+
+} //anonymous namespace
+
+TEST_GROUP(IntrusiveList) {};
+
+TEST(IntrusiveList,BaseHook)
+{
+    utl::array<request,4> requests{};
+    for(size_t idx = 0; idx < requests.size(); idx++) requests[idx].id = static_cast<int>(idx);
+
+    utl::intrusive_list<request> list{};
+    CHECK(list.empty());
+    CHECK(not requests[0].is_linked());
+
+    list.push_back(requests[1]);
+    list.push_back(requests[2]);
+    list.push_front(requests[0]);
+    CHECK(ids_are(list, {0, 1, 2}));
+    CHECK(requests[0].is_linked());
+    CHECK_EQUAL(0, list.front().id);
+    CHECK_EQUAL(2, list.back().id);
+
+    //removal from the middle, given just the element
+    list.erase(requests[1]);
+    CHECK(not requests[1].is_linked());
+    CHECK(ids_are(list, {0, 2}));
+
+    list.insert(list.iterator_to(requests[2]), requests[3]);
+    CHECK(ids_are(list, {0, 3, 2}));
+
+    //backwards from the end
+    auto iter = list.end();
+    --iter;
+    CHECK_EQUAL(2, iter->id);
+    iter--;
+    CHECK_EQUAL(3, iter->id);
+
+    //erasing while iterating
+    for(auto pos = list.begin(); pos != list.end();) {
+        pos = pos->id == 3 ? list.erase(pos) : ++pos;
+    }
+    CHECK(ids_are(list, {0, 2}));
+
+    list.pop_front();
+    CHECK(ids_are(list, {2}));
+    list.pop_back();
+    CHECK(list.empty());
+
+    list.push_back(requests[0]);
+    list.push_back(requests[1]);
+    list.clear();
+    CHECK(list.empty());
+    CHECK(not requests[0].is_linked());
+    CHECK(not requests[1].is_linked());
+}
+
+TEST(IntrusiveList,MemberHooks)
+{
+    utl::array<buffer,4> buffers{};
+    for(size_t idx = 0; idx < buffers.size(); idx++) buffers[idx].id = static_cast<int>(idx);
+
+    utl::intrusive_list<buffer,&buffer::pending> pending{};
+    utl::intrusive_slist<buffer,&buffer::free> free{};
+    for(auto& buf : buffers) free.push_back(buf);
+    pending.push_back(buffers[2]);
+    pending.push_back(buffers[0]);
+
+    CHECK(ids_are(free, {0, 1, 2, 3}));
+    CHECK(ids_are(pending, {2, 0}));
+    CHECK(&pending.front() == &buffers[2]);
+
+    //a copy isn't in any list
+    const buffer copy = buffers[2];
+    CHECK(not copy.pending.is_linked());
+    CHECK(buffers[2].pending.is_linked());
+}
+
+TEST(IntrusiveList,Mixin)
+{
+    utl::array<linked_driver,3> drivers{};
+    for(size_t idx = 0; idx < drivers.size(); idx++) drivers[idx].id = static_cast<int>(idx);
+    utl::intrusive_list<linked_driver> list{};
+    for(auto& driver : drivers) list.push_front(driver);
+    CHECK(ids_are(list, {2, 1, 0}));
+}
+
+TEST(IntrusiveList,Singly)
+{
+    utl::array<buffer,4> buffers{};
+    for(size_t idx = 0; idx < buffers.size(); idx++) buffers[idx].id = static_cast<int>(idx);
+    utl::intrusive_slist<buffer,&buffer::free> list{};
+
+    //as a FIFO
+    list.push_back(buffers[0]);
+    list.push_back(buffers[1]);
+    list.push_front(buffers[2]);
+    CHECK(ids_are(list, {2, 0, 1}));
+    CHECK_EQUAL(1, list.back().id);
+    list.pop_front();
+    CHECK(not buffers[2].free.is_linked());
+    CHECK(ids_are(list, {0, 1}));
+
+    //removing the tail moves it back
+    CHECK(list.remove(buffers[1]));
+    CHECK(not list.remove(buffers[1]));
+    CHECK_EQUAL(0, list.back().id);
+    list.push_back(buffers[3]);
+    CHECK(ids_are(list, {0, 3}));
+
+    list.insert_after(list.begin(), buffers[1]);
+    CHECK(ids_are(list, {0, 1, 3}));
+    list.erase_after(list.begin());
+    CHECK(ids_are(list, {0, 3}));
+
+    list.clear();
+    CHECK(list.empty());
+    list.push_back(buffers[2]);
+    CHECK(ids_are(list, {2}));
+    CHECK_EQUAL(2, list.front().id);
+    CHECK_EQUAL(2, list.back().id);
+}
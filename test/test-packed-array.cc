@@ -0,0 +1,106 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/packed-array.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+using sample_t = utl::uintn_t<12>;
+using samples_t = utl::packed_array<sample_t,100>;
+
+static_assert(samples_t::storage_size() == 152); //150 bytes, rounded up to a word
+static_assert(utl::packed_array<utl::uintn_t<5>,64>::storage_size() == 40);
+
+constexpr auto make_ramp()
+{
+    samples_t samples{};
+    for(size_t idx = 0; idx < samples.size(); idx++) samples.set(idx, static_cast<sample_t>(idx * 41));
+    return samples;
+}
+
+static_assert(make_ramp().get(0) == 0);
+static_assert(make_ramp().get(99) == 99 * 41);
+
+constexpr sample_t ramp(size_t idx) { return static_cast<sample_t>(idx * 41); }
+
+} //anonymous namespace
+
+TEST_GROUP(PackedArray) {};
+
+TEST(PackedArray,GetSet)
+{
+    samples_t samples{};
+    for(size_t idx = 0; idx < samples.size(); idx++) samples.set(idx, ramp(idx));
+    for(size_t idx = 0; idx < samples.size(); idx++) {
+        CHECK(samples.get(idx) == ramp(idx));
+    }
+
+    //overwriting one element leaves its neighbours alone, including
+    //across a word boundary (element 5 is bits 60..71)
+    samples.set(5, 0xFFF);
+    CHECK(samples.get(4) == ramp(4));
+    CHECK(samples.get(5) == 0xFFF);
+    CHECK(samples.get(6) == ramp(6));
+    samples.set(5, 0);
+    CHECK(samples.get(4) == ramp(4));
+    CHECK(samples.get(5) == 0);
+    CHECK(samples.get(6) == ramp(6));
+}
+
+TEST(PackedArray,Reference)
+{
+    utl::packed_array<utl::uintn_t<5>,20> values{};
+    values[3] = 17;
+    values[4] = values[3];
+    const utl::uintn_t<5> read = values[4];
+    CHECK(read == 17);
+    CHECK(values.get(2) == 0);
+    CHECK(values.get(5) == 0);
+}
+
+TEST(PackedArray,Fill)
+{
+    utl::packed_array<utl::uintn_t<5>,70> values{};
+    values.fill(0b10101);
+    for(size_t idx = 0; idx < values.size(); idx++) {
+        CHECK(values.get(idx) == 0b10101);
+    }
+    //nothing past the last element is set
+    const auto words = values.words();
+    const auto last = words[words.size() - 1];
+    CHECK((last >> ((70 * 5) % (sizeof(last) * 8))) == 0);
+
+    utl::packed_array<uint8_t,9> bytes{};
+    bytes.fill(0xA5);
+    CHECK(bytes.get(8) == 0xA5);
+}
+
+TEST(PackedArray,PackUnpack)
+{
+    utl::array<sample_t,100> plain{};
+    for(size_t idx = 0; idx < plain.size(); idx++) plain[idx] = ramp(idx);
+
+    samples_t samples{};
+    samples.pack(plain);
+    const auto unpacked = samples.unpack();
+    for(size_t idx = 0; idx < plain.size(); idx++) {
+        CHECK(unpacked[idx] == plain[idx]);
+    }
+
+    utl::packed_array<uint64_t,3> wide{};
+    wide.set(1, 0xFEDC'BA98'7654'3210);
+    CHECK(wide.get(0) == 0);
+    CHECK(wide.get(1) == 0xFEDC'BA98'7654'3210);
+    CHECK(wide.get(2) == 0);
+}
@@ -0,0 +1,424 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/register/register.hh>
+#include <utl/register/field.hh>
+#include <utl/register/op.hh>
+#include <utl/register/host.hh>
+#include <utl/register/register2.hh>
+#include <utl/register/wait.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+using utl::registers::host::mock_register;
+using utl::registers::host::direction;
+
+using control = mock_register<0x4000'0000>;
+using mode = utl::registers::field::field<control,0,2>;
+using enable = utl::registers::field::field<control,2,1>;
+using prescaler = utl::registers::field::field<control,8,8>;
+
+using status = mock_register<0x4000'0004, 32, 0xFFFF'0000>;
+using flags = utl::registers::field::field<status,16,4>;
+using count = utl::registers::field::field<status,0,16>;
+
+using narrow = mock_register<0x4000'0008, 16, 0x00FF>;
+
+using command = utl::registers::shadowed<mock_register<0x4000'000C, 32, 0x0000'0100>>;
+using opcode = utl::registers::field::field<command,0,8>;
+using argument = utl::registers::field::field<command,8,8>;
+using start = utl::registers::field::field<command,31,1>;
+
+static_assert(utl::registers::any_readable_register<control>);
+static_assert(utl::registers::any_writable_register<control>);
+//An STM32-style GPIO output register and its set/reset alias.
+struct gpio_bsrr : mock_register<0x4800'0018> {
+    static constexpr size_t clear_offset() { return 16; }
+};
+struct gpio_odr : mock_register<0x4800'0014> {
+    using set_clear_t = gpio_bsrr;
+};
+using pin3 = utl::registers::field::field<gpio_odr,3,1>;
+using pins8to11 = utl::registers::field::field<gpio_odr,8,4>;
+using pins12to19 = utl::registers::field::field<gpio_odr,12,8>;
+
+//nRF-style separate set and clear registers
+struct outset : mock_register<0x5000'0508> {};
+struct outclr : mock_register<0x5000'050C> {};
+struct out : mock_register<0x5000'0504> {
+    using set_t = outset;
+    using clear_t = outclr;
+};
+using led = utl::registers::field::field<out,17,4>;
+using led0 = utl::registers::field::field<out,22,1>;
+using led1 = utl::registers::field::field<out,23,1>;
+
+//a register in the peripheral bit-band region
+struct banded : mock_register<0x4001'080C> {
+    template <size_t Bit>
+    using bit_alias_t = mock_register<utl::registers::bit_band_alias(address(), Bit)>;
+};
+using ready = utl::registers::field::field<banded,5,1>;
+using level = utl::registers::field::field<banded,6,2>;
+
+static_assert(utl::registers::has_set_clear_register<gpio_odr>);
+static_assert(utl::registers::has_set_and_clear_registers<out>);
+static_assert(utl::registers::has_bit_aliases<banded>);
+static_assert(not utl::registers::has_bit_aliases<control>);
+
+static_assert(utl::registers::any_readable_register<command>);
+static_assert(utl::registers::any_shadowed_register<command>);
+static_assert(utl::registers::ops::any_op<decltype(utl::registers::ops::set(enable{}))>);
+static_assert(utl::registers::ops::any_composed_ops<decltype(utl::registers::ops::compose(
+    utl::registers::ops::set(enable{}), utl::registers::ops::clear(flags{})))>);
+
+} //anonymous namespace
+
+TEST_GROUP(RegisterHost) {
+    utl::registers::host::register_file file{};
+    utl::registers::host::push_register_file pushed{file};
+};
+
+TEST(RegisterHost,ReadsResetValue)
+{
+    CHECK_EQUAL(0xFFFF'0000u, utl::registers::read(status{}));
+    CHECK_EQUAL(0x00FFu, utl::registers::read(narrow{}));
+    CHECK_EQUAL(2u, file.reads());
+    CHECK_EQUAL(0u, file.writes());
+}
+
+TEST(RegisterHost,Trace)
+{
+    utl::registers::write(control{}, 0x1234u);
+    utl::registers::write(narrow{}, uint16_t{0xBEEF});
+    CHECK_EQUAL(0x1234u, utl::registers::read(control{}));
+
+    const auto trace = file.trace();
+    CHECK_EQUAL(3u, trace.size());
+    CHECK_EQUAL(control::address(), trace[0].address);
+    CHECK(trace[0].dir == direction::write);
+    CHECK_EQUAL(narrow::address(), trace[1].address);
+    CHECK_EQUAL(16u, trace[1].width);
+    CHECK_EQUAL(0xBEEFu, trace[1].value);
+    CHECK(trace[2].dir == direction::read);
+    CHECK_EQUAL(1u, file.count(control::address(), direction::read));
+    CHECK_EQUAL(1u, file.count(control::address(), direction::write));
+    CHECK(not file.overflowed());
+}
+
+TEST(RegisterHost,PeekPoke)
+{
+    file.poke(control::address(), 0x55);
+    CHECK_EQUAL(0x55u, utl::registers::read(control{}));
+    utl::registers::write(control{}, 0xAAu);
+    CHECK_EQUAL(0xAAu, file.peek(control::address()));
+    CHECK_EQUAL(2u, file.accesses());
+}
+
+TEST(RegisterHost,TraceOverflow)
+{
+    constexpr size_t n = utl::registers::host::register_file::max_accesses + 10;
+    for(size_t idx = 0; idx < n; idx++) {
+        utl::registers::write(control{}, static_cast<uint32_t>(idx));
+    }
+    CHECK_EQUAL(n, file.writes());
+    CHECK_EQUAL(utl::registers::host::register_file::max_accesses, file.trace().size());
+    CHECK(file.overflowed());
+    CHECK_EQUAL(n, file.count(control::address(), direction::write));
+    CHECK_EQUAL(n - 1, file.peek(control::address()));
+
+    file.clear_trace();
+    CHECK_EQUAL(0u, file.count(control::address(), direction::write));
+}
+
+TEST(RegisterHost,Nesting)
+{
+    utl::registers::host::register_file inner{};
+    {
+        utl::registers::host::push_register_file pushed_inner{inner};
+        utl::registers::write(control{}, 1u);
+    }
+    utl::registers::write(control{}, 2u);
+    CHECK_EQUAL(1u, inner.writes());
+    CHECK_EQUAL(1u, file.writes());
+    CHECK_EQUAL(1u, inner.peek(control::address()));
+}
+
+TEST_GROUP(RegisterField) {};
+
+TEST(RegisterField,Align)
+{
+    CHECK_EQUAL(0x0000'2A00u, utl::registers::field::align_to_register(prescaler{}, 0x2A));
+    CHECK_EQUAL(0x0000'FF00u, utl::registers::field::mask(prescaler{}));
+    CHECK_EQUAL(0xFFFF'FFFFu, utl::registers::field::mask(utl::registers::field::field<control,0,32>{}));
+    CHECK_EQUAL(0x2Au, static_cast<uint32_t>(utl::registers::field::align_from_register(prescaler{}, 0x1234'2A56)));
+}
+
+TEST_GROUP(RegisterOps) {
+    utl::registers::host::register_file file{};
+    utl::registers::host::push_register_file pushed{file};
+};
+
+TEST(RegisterOps,SingleOp)
+{
+    using namespace utl::registers::ops;
+    apply(set(enable{}));
+    CHECK_EQUAL(0x4u, file.peek(control::address()));
+    CHECK_EQUAL(1u, file.reads());
+    CHECK_EQUAL(1u, file.writes());
+}
+
+TEST(RegisterOps,CoalescesOneRegister)
+{
+    using namespace utl::registers::ops;
+    file.poke(control::address(), 0xFFFF'FFFF);
+    apply(compose(assign(mode{}, 1), clear(enable{}), assign(prescaler{}, 0x10)));
+    CHECK_EQUAL(0xFFFF'10F9u, file.peek(control::address()));
+    CHECK_EQUAL(1u, file.reads());
+    CHECK_EQUAL(1u, file.writes());
+}
+
+TEST(RegisterOps,CoalescesAcrossRegisters)
+{
+    using namespace utl::registers::ops;
+    apply(
+        assign(flags{}, 0x5),
+        compose(set(enable{}), compose(assign(count{}, 0x1234), assign(mode{}, 3))),
+        assign(prescaler{}, 0xAB)
+    );
+    CHECK_EQUAL(0xFFF5'1234u, file.peek(status::address()));
+    CHECK_EQUAL(0x0000'AB07u, file.peek(control::address()));
+    CHECK_EQUAL(2u, file.reads());
+    CHECK_EQUAL(2u, file.writes());
+
+    //registers are committed in the order they're first mentioned
+    const auto trace = file.trace();
+    CHECK_EQUAL(4u, trace.size());
+    CHECK(trace[0].address == status::address() and trace[0].dir == direction::read);
+    CHECK(trace[1].address == status::address() and trace[1].dir == direction::write);
+    CHECK(trace[2].address == control::address() and trace[2].dir == direction::read);
+    CHECK(trace[3].address == control::address() and trace[3].dir == direction::write);
+}
+
+TEST(RegisterOps,LaterOpWins)
+{
+    using namespace utl::registers::ops;
+    apply(set(enable{}), assign(mode{}, 2), clear(enable{}), assign(mode{}, 1));
+    CHECK_EQUAL(0x1u, file.peek(control::address()));
+    CHECK_EQUAL(1u, file.writes());
+}
+
+TEST(RegisterOps,Evaluate)
+{
+    using namespace utl::registers::ops;
+    constexpr auto merged = merge(set(enable{}).lower(), assign(mode{}, 2).lower());
+    static_assert(evaluate(control{}, uint32_t{0xFFFF'FFFF}, merged) == 0xFFFF'FFFE);
+    static_assert(evaluate(control{}, uint32_t{0}, merged) == 0x6);
+}
+
+TEST_GROUP(RegisterShadow) {
+    utl::registers::host::register_file file{};
+    utl::registers::host::push_register_file pushed{file};
+
+    void setup() override { command::reset(); }
+};
+
+TEST(RegisterShadow,ReadsAreFree)
+{
+    CHECK_EQUAL(0x100u, utl::registers::read(command{}));
+    CHECK_EQUAL(0u, file.accesses());
+}
+
+TEST(RegisterShadow,FieldOpsStoreOnce)
+{
+    using namespace utl::registers::ops;
+    apply(assign(opcode{}, 0x42), set(start{}));
+    CHECK_EQUAL(0x8000'0142u, command::peek());
+    CHECK_EQUAL(0x8000'0142u, file.peek(command::register_t::address()));
+
+    apply(assign(argument{}, 0x7), clear(start{}));
+    CHECK_EQUAL(0x0000'0742u, command::peek());
+    CHECK_EQUAL(0x0000'0742u, file.peek(command::register_t::address()));
+
+    CHECK_EQUAL(0u, file.reads());
+    CHECK_EQUAL(2u, file.writes());
+}
+
+TEST_GROUP(RegisterAlias) {
+    utl::registers::host::register_file file{};
+    utl::registers::host::push_register_file pushed{file};
+};
+
+TEST(RegisterAlias,SetClearRegister)
+{
+    using namespace utl::registers::ops;
+    apply(set(pin3{}), assign(pins8to11{}, 0b1010));
+    CHECK_EQUAL(0u, file.reads());
+    CHECK_EQUAL(1u, file.writes());
+    CHECK_EQUAL(0u, file.count(gpio_odr::address(), direction::write));
+    CHECK_EQUAL(0x0500'0A08u, file.peek(gpio_bsrr::address()));
+}
+
+TEST(RegisterAlias,SetClearRegisterTooNarrow)
+{
+    //bits 16 and up can't be reached through the alias
+    using namespace utl::registers::ops;
+    apply(assign(pins12to19{}, 0xA5));
+    CHECK_EQUAL(1u, file.reads());
+    CHECK_EQUAL(1u, file.writes());
+    CHECK_EQUAL(0x000A'5000u, file.peek(gpio_odr::address()));
+}
+
+TEST(RegisterAlias,SetAndClearRegisters)
+{
+    using namespace utl::registers::ops;
+    apply(set(led0{}), clear(led1{}), assign(led{}, 0b1111));
+    CHECK_EQUAL(0u, file.reads());
+    CHECK_EQUAL(2u, file.writes());
+    CHECK_EQUAL((1u << 22) | (0b1111u << 17), file.peek(outset::address()));
+    CHECK_EQUAL(1u << 23, file.peek(outclr::address()));
+
+    file.clear_trace();
+    apply(set(led{}));
+    CHECK_EQUAL(1u, file.writes());
+    CHECK_EQUAL(1u, file.count(outset::address(), direction::write));
+}
+
+TEST(RegisterAlias,SetAndClearRegistersSplitField)
+{
+    //storing the set bits and then the clear bits would pass led
+    //through 0b0111 on its way from 0b0101 to 0b0110
+    using namespace utl::registers::ops;
+    file.poke(out::address(), 0b0101u << 17);
+    apply(assign(led{}, 0b0110), set(led0{}));
+    CHECK_EQUAL(1u, file.reads());
+    CHECK_EQUAL(1u, file.writes());
+    CHECK_EQUAL(0u, file.count(outset::address(), direction::write));
+    CHECK_EQUAL(0u, file.count(outclr::address(), direction::write));
+    CHECK_EQUAL((0b0110u << 17) | (1u << 22), file.peek(out::address()));
+}
+
+TEST(RegisterAlias,BitBand)
+{
+    using namespace utl::registers::ops;
+    using alias = banded::bit_alias_t<5>;
+    file.poke(alias::address(), 0xFF);
+    apply(clear(ready{}));
+    CHECK_EQUAL(0u, file.reads());
+    CHECK_EQUAL(1u, file.writes());
+    CHECK_EQUAL(0u, file.peek(alias::address()));
+    apply(set(ready{}));
+    CHECK_EQUAL(1u, file.peek(alias::address()));
+
+    //multi-bit fields still need a read-modify-write
+    file.clear_trace();
+    apply(assign(level{}, 2));
+    CHECK_EQUAL(1u, file.reads());
+    CHECK_EQUAL(0x80u, file.peek(banded::address()));
+}
+
+TEST_GROUP(RegisterWait) {
+    utl::registers::host::register_file file{};
+    utl::registers::host::push_register_file pushed{file};
+};
+
+TEST(RegisterWait,AlreadySet)
+{
+    file.poke(status::address(), 0x0003'0000);
+    auto res = utl::registers::wait_until(flags{}, [](auto v) { return v == 0x3; }, 10u);
+    CHECK(res.has_value());
+    CHECK_EQUAL(1u, res.value());
+    CHECK_EQUAL(1u, file.reads());
+}
+
+TEST(RegisterWait,Backoff)
+{
+    //the backoff hook plays the part of the hardware
+    auto hardware = [&](size_t attempt) {
+        if(attempt == 4) file.poke(status::address(), 0x0001'0000);
+    };
+    utl::registers::spin_statistics stats{};
+    auto res = utl::registers::wait_until(flags{}, [](auto v) { return v == 0x1; }, 100u, hardware, stats);
+    CHECK(res.has_value());
+    CHECK_EQUAL(6u, res.value());
+    CHECK_EQUAL(6u, file.reads());
+    CHECK_EQUAL(1u, stats.calls);
+    CHECK_EQUAL(6u, stats.longest);
+}
+
+TEST(RegisterWait,Timeout)
+{
+    utl::registers::spin_statistics stats{};
+    for(size_t idx = 0; idx < 2; idx++) {
+        auto res = utl::registers::wait_until(flags{}, [](auto v) { return v == 0x1; }, 8u,
+            utl::registers::spin_backoff{16}, stats);
+        CHECK(not res.has_value());
+        CHECK_EQUAL(static_cast<int32_t>(utl::errc::timeout), res.error().value());
+    }
+    CHECK_EQUAL(16u, file.reads());
+    CHECK_EQUAL(2u, stats.calls);
+    CHECK_EQUAL(2u, stats.timeouts);
+    CHECK_EQUAL(8u, stats.mean());
+}
+
+TEST(RegisterWait,Ticks)
+{
+    uint32_t now = 0xFFFF'FFF0; //wraps during the wait
+    auto clock = [&]() { return now += 3; };
+    auto res = utl::registers::wait_until(flags{}, [](auto v) { return v == 0x1; },
+        utl::registers::tick_budget{clock, 30u});
+    CHECK_EQUAL(static_cast<int32_t>(utl::errc::timeout), res.error().value());
+    CHECK_EQUAL(10u, file.reads());
+
+    //a const budget works too; the wait reads the clock through its own copy
+    file.clear_trace();
+    const utl::registers::tick_budget budget{clock, 30u};
+    auto again = utl::registers::wait_until(flags{}, [](auto v) { return v == 0x1; }, budget);
+    CHECK(not again.has_value());
+    CHECK_EQUAL(10u, file.reads());
+}
+
+TEST_GROUP(RegisterBenchmark) {
+    utl::registers::host::register_file file{};
+    utl::registers::host::push_register_file pushed{file};
+};
+
+TEST(RegisterBenchmark,Coalescing)
+{
+    using namespace utl::registers::ops;
+    constexpr size_t iterations = 100000;
+
+    const auto separate = utl::bench::measure(iterations, [&](size_t idx) {
+        const auto n = static_cast<uint8_t>(idx);
+        apply(assign(prescaler{}, n));
+        apply(assign(mode{}, static_cast<utl::uintn_t<2>>(idx)));
+        apply(set(enable{}));
+        apply(assign(count{}, static_cast<uint16_t>(idx)));
+    });
+    const auto separate_accesses = file.accesses();
+    file.clear_trace();
+
+    const auto coalesced = utl::bench::measure(iterations, [&](size_t idx) {
+        const auto n = static_cast<uint8_t>(idx);
+        apply(assign(prescaler{}, n), assign(mode{}, static_cast<utl::uintn_t<2>>(idx)),
+            set(enable{}), assign(count{}, static_cast<uint16_t>(idx)));
+    });
+    const auto coalesced_accesses = file.accesses();
+
+    CHECK_EQUAL(iterations*8, separate_accesses);
+    CHECK_EQUAL(iterations*4, coalesced_accesses);
+    utl::log("bench register accesses: separate {}, coalesced {}", separate_accesses, coalesced_accesses);
+    utl::bench::report("register field updates, coalesced"_sv, separate, coalesced);
+}
@@ -0,0 +1,206 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/test-types.hh>
+#include <utl/utl.hh>
+#include <utl/seqlock.hh>
+#include <atomic>
+#include <thread>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+//Every word is derived from the same counter, so a torn
+//snapshot is easy to spot.
+struct snapshot {
+    uint32_t sequence;
+    uint32_t samples[9]; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+
+    static constexpr snapshot make(uint32_t n)
+    {
+        snapshot s{n,{}};
+        for(uint32_t idx = 0; idx < 9; idx++) {
+            s.samples[idx] = n * (idx + 1) + idx; //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        return s;
+    }
+
+    [[nodiscard]] constexpr bool consistent() const
+    {
+        return make(sequence).samples[8] == samples[8]
+            and make(sequence).samples[0] == samples[0]
+            and make(sequence).samples[4] == samples[4];
+    }
+};
+
+struct odd_sized {
+    uint8_t bytes[13]; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+};
+
+static_assert(utl::any_snapshot<snapshot>);
+static_assert(utl::any_snapshot<odd_sized>);
+
+constexpr uint32_t stress_writes = 200000;
+
+} //anonymous namespace
+
+TEST_GROUP(Seqlock) {};
+
+TEST(Seqlock,DefaultIsZero)
+{
+    const utl::seqlock<snapshot> lock{};
+    const auto value = lock.read();
+    CHECK_EQUAL(0u, value.sequence);
+    CHECK_EQUAL(0u, lock.version());
+}
+
+TEST(Seqlock,WriteThenRead)
+{
+    utl::seqlock<snapshot> lock{};
+    lock.write(snapshot::make(42));
+    const auto value = lock.read();
+    CHECK_EQUAL(42u, value.sequence);
+    CHECK(value.consistent());
+    CHECK_EQUAL(1u, lock.version());
+}
+
+TEST(Seqlock,TryRead)
+{
+    utl::seqlock<snapshot> lock{snapshot::make(7)};
+    auto res = lock.try_read();
+    CHECK(res.has_value());
+    CHECK_EQUAL(7u, res.value().sequence);
+}
+
+TEST(Seqlock,OddSizedPayload)
+{
+    utl::seqlock<odd_sized> lock{};
+    odd_sized in{};
+    for(uint8_t idx = 0; idx < 13; idx++) in.bytes[idx] = static_cast<uint8_t>(idx * 3); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    lock.write(in);
+    const auto out = lock.read();
+    CHECK_EQUAL(0, __builtin_memcmp(&in, &out, sizeof(odd_sized)));
+}
+
+TEST(Seqlock,Stress)
+{
+    utl::seqlock<snapshot> lock{snapshot::make(0)};
+    std::atomic<bool> done{false};
+
+    std::thread writer{[&] {
+        for(uint32_t n = 1; n <= stress_writes; n++) {
+            lock.write(snapshot::make(n));
+        }
+        done.store(true);
+    }};
+
+    uint32_t torn = 0;
+    uint32_t regressed = 0;
+    uint32_t last = 0;
+    while(not done.load()) {
+        const auto value = lock.read();
+        if(not value.consistent()) torn++;
+        if(value.sequence < last) regressed++;
+        last = value.sequence;
+    }
+    writer.join();
+
+    CHECK_EQUAL(0u, torn);
+    CHECK_EQUAL(0u, regressed);
+    CHECK_EQUAL(stress_writes, lock.read().sequence);
+}
+
+TEST_GROUP(TripleBuffer) {};
+
+TEST(TripleBuffer,WriteThenRead)
+{
+    utl::triple_buffer<snapshot> buffer{};
+    CHECK(not buffer.has_update());
+    buffer.write(snapshot::make(3));
+    CHECK(buffer.has_update());
+    CHECK_EQUAL(3u, buffer.read().sequence);
+    CHECK(not buffer.has_update());
+}
+
+TEST(TripleBuffer,ReadsLatest)
+{
+    utl::triple_buffer<snapshot> buffer{};
+    buffer.write(snapshot::make(1));
+    buffer.write(snapshot::make(2));
+    buffer.write(snapshot::make(3));
+    CHECK_EQUAL(3u, buffer.read().sequence);
+    CHECK_EQUAL(3u, buffer.read().sequence);
+}
+
+TEST(TripleBuffer,Stress)
+{
+    utl::triple_buffer<snapshot> buffer{};
+    buffer.write(snapshot::make(0));
+    std::atomic<bool> done{false};
+
+    std::thread writer{[&] {
+        for(uint32_t n = 1; n <= stress_writes; n++) {
+            buffer.write(snapshot::make(n));
+        }
+        done.store(true);
+    }};
+
+    uint32_t torn = 0;
+    uint32_t regressed = 0;
+    uint32_t last = 0;
+    while(not done.load()) {
+        auto const& value = buffer.read();
+        if(not value.consistent()) torn++;
+        if(value.sequence < last) regressed++;
+        last = value.sequence;
+    }
+    writer.join();
+
+    CHECK_EQUAL(0u, torn);
+    CHECK_EQUAL(0u, regressed);
+    CHECK_EQUAL(stress_writes, buffer.read().sequence);
+}
+
+TEST_GROUP(SeqlockBenchmark) {};
+
+TEST(SeqlockBenchmark,ReadThroughput)
+{
+    constexpr size_t iterations = 1000000;
+
+    utl::seqlock<snapshot> lock{snapshot::make(1)};
+    const auto uncontended = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(lock.read());
+    });
+    utl::bench::report("seqlock read, uncontended"_sv, uncontended);
+
+    utl::triple_buffer<snapshot> buffer{};
+    buffer.write(snapshot::make(1));
+    const auto triple = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(buffer.read());
+    });
+    utl::bench::report("triple_buffer read, uncontended"_sv, triple);
+
+    std::atomic<bool> done{false};
+    std::thread writer{[&] {
+        uint32_t n = 0;
+        while(not done.load(std::memory_order_relaxed)) {
+            lock.write(snapshot::make(n++));
+        }
+    }};
+    const auto contended = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(lock.read());
+    });
+    done.store(true);
+    writer.join();
+    utl::bench::report("seqlock read, continuous writer"_sv, contended);
+}
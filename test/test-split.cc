@@ -0,0 +1,103 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/ranges.hh>
+#include <utl/ranges/split.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+constexpr size_t count(auto&& range)
+{
+    size_t total = 0;
+    for([[maybe_unused]] auto slice : range) total++;
+    return total;
+}
+
+static_assert(count(utl::ranges::split("a,b,,c"_sv, ',')) == 4);
+static_assert(count(utl::ranges::tokenize("  set  rate 10 "_sv)) == 3);
+static_assert(count(utl::ranges::lines("one\r\ntwo\n"_sv)) == 2);
+static_assert(utl::ranges::iterable<decltype(utl::ranges::split(""_sv, ','))>);
+
+template <size_t N>
+void check_slices(auto&& range, utl::string_view const (&expected)[N]) //NOLINT(cppcoreguidelines-avoid-c-arrays)
+{
+    size_t idx = 0;
+    for(auto slice : range) {
+        CHECK(idx < N);
+        if(idx < N) CHECK(slice == expected[idx]); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        idx++;
+    }
+    CHECK_EQUAL(N, idx);
+}
+
+} //anonymous namespace
+
+TEST_GROUP(Split) {};
+
+TEST(Split,Char)
+{
+    check_slices(utl::ranges::split("a,b,,c"_sv, ','), {"a"_sv, "b"_sv, ""_sv, "c"_sv});
+    check_slices(utl::ranges::split(",a,"_sv, ','), {""_sv, "a"_sv, ""_sv});
+    check_slices(utl::ranges::split("abc"_sv, ','), {"abc"_sv});
+    CHECK(utl::ranges::split(""_sv, ',').empty());
+}
+
+TEST(Split,String)
+{
+    check_slices(utl::ranges::split("k1 := v1 := v2"_sv, " := "_sv), {"k1"_sv, "v1"_sv, "v2"_sv});
+    check_slices(utl::ranges::split("abc"_sv, ""_sv), {"abc"_sv});
+    check_slices(utl::ranges::split("--"_sv, "--"_sv), {""_sv, ""_sv});
+}
+
+TEST(Split,Any)
+{
+    check_slices(utl::ranges::split_any("a=1;b=2"_sv, "=;"_sv), {"a"_sv, "1"_sv, "b"_sv, "2"_sv});
+    //more than a handful of delimiters
+    check_slices(utl::ranges::split_any("a.b,c;d:e!f"_sv, ".,;:!?"_sv), {"a"_sv, "b"_sv, "c"_sv, "d"_sv, "e"_sv, "f"_sv});
+}
+
+TEST(Split,Tokenize)
+{
+    check_slices(utl::ranges::tokenize("  set\t rate  10\r\n"_sv), {"set"_sv, "rate"_sv, "10"_sv});
+    check_slices(utl::ranges::tokenize("a,,b,"_sv, ","_sv), {"a"_sv, "b"_sv});
+    CHECK(utl::ranges::tokenize(" \t "_sv).empty());
+    CHECK(utl::ranges::tokenize(""_sv).empty());
+}
+
+TEST(Split,Lines)
+{
+    check_slices(utl::ranges::lines("one\r\ntwo\n\nfour"_sv), {"one"_sv, "two"_sv, ""_sv, "four"_sv});
+    check_slices(utl::ranges::lines("\n"_sv), {""_sv});
+    check_slices(utl::ranges::lines("\r\n"_sv), {""_sv});
+    CHECK(utl::ranges::lines(""_sv).empty());
+}
+
+TEST(Split,Nested)
+{
+    //the slices point into the original text
+    const auto text = "rate=100\ngain=4\n"_sv;
+    size_t total = 0;
+    for(auto line : utl::ranges::lines(text)) {
+        for(auto field : utl::ranges::split(line, '=')) {
+            CHECK(field.data() >= text.data() and field.data() < text.data() + text.size()); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+            total += field.size();
+        }
+    }
+    CHECK_EQUAL(12u, total);
+
+    //iterators outlive the range they came from
+    auto iter = utl::ranges::begin(utl::ranges::tokenize("x y z"_sv));
+    iter++;
+    CHECK((*iter == "y"_sv));
+}
@@ -0,0 +1,203 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/ranges.hh>
+#include <utl/static-hash-map.hh>
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+constexpr utl::static_hash_map<int,int,4> squares{{3, 9}, {1, 1}, {2, 4}};
+
+static_assert(squares.size() == 3);
+static_assert(squares.contains(2));
+static_assert(not squares.contains(4));
+static_assert(*squares.find(3) == 9);
+static_assert(utl::ranges::iterable<utl::static_hash_map<int,int,4>>);
+
+//later duplicates win, and don't count against the capacity; a third
+//distinct key here would fail to compile
+constexpr utl::static_hash_map<int,int,2> deduplicated{{1, 1}, {1, 2}, {5, 5}, {5, 6}};
+static_assert(deduplicated.size() == 2 and *deduplicated.find(1) == 2 and *deduplicated.find(5) == 6);
+
+//a map built at compile time keeps working after erasures
+constexpr bool erase_keeps_others()
+{
+    utl::static_hash_map<int,int,8> map{};
+    for(int key = 0; key < 8; key++) {
+        if(not map.insert(key * 16, key).has_value()) return false;
+    }
+    for(int key = 0; key < 8; key += 2) map.erase(key * 16);
+    for(int key = 0; key < 8; key++) {
+        if(map.contains(key * 16) != (key % 2 == 1)) return false;
+    }
+    return map.size() == 4;
+}
+static_assert(erase_keeps_others());
+
+//every key hashes to the same slot, so they all collide
+struct collide {
+    constexpr size_t operator()(int) const { return 0; }
+};
+
+struct pair_entry {
+    uint32_t key;
+    uint32_t value;
+};
+
+} //anonymous namespace
+
+TEST_GROUP(StaticHashMap) {};
+
+TEST(StaticHashMap,InsertFindErase)
+{
+    utl::static_hash_map<int,int,4> map{};
+    CHECK(map.empty());
+    CHECK(map.find(1) == nullptr);
+
+    CHECK(map.insert(20, 200).has_value());
+    CHECK(map.insert(10, 100).has_value());
+    CHECK(map.insert(30, 300).has_value());
+    CHECK_EQUAL(3u, map.size());
+
+    //insert leaves an existing value alone; insert_or_assign replaces it
+    const auto kept = map.insert(10, 111);
+    CHECK_EQUAL(100, kept.value());
+    const auto replaced = map.insert_or_assign(10, 111);
+    CHECK_EQUAL(111, replaced.value());
+
+    CHECK(map.insert(40, 400).has_value());
+    CHECK(map.full());
+    const auto overflow = map.insert(50, 500);
+    CHECK(not overflow.has_value());
+    CHECK_EQUAL(static_cast<int32_t>(utl::errc::out_of_bounds), overflow.error().value());
+
+    int key_sum = 0;
+    size_t count = 0;
+    for(auto entry : map) {
+        key_sum += utl::get<0>(entry);
+        utl::get<1>(entry)++;
+        count++;
+    }
+    CHECK_EQUAL(4u, count);
+    CHECK_EQUAL(100, key_sum);
+    CHECK_EQUAL(201, *map.find(20));
+
+    CHECK(map.erase(20));
+    CHECK(not map.erase(20));
+    CHECK(not map.contains(20));
+    CHECK_EQUAL(3u, map.size());
+    CHECK_EQUAL(112, *map.find(10));
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(not map.contains(10));
+}
+
+TEST(StaticHashMap,Collisions)
+{
+    //with every key in one probe sequence, erasing from the middle has
+    //to shift the rest back for them to stay reachable
+    utl::static_hash_map<int,int,16,collide> map{};
+    for(int key = 0; key < 16; key++) CHECK(map.insert(key, key * 10).has_value());
+    CHECK(map.full());
+    for(int key = 0; key < 16; key += 3) CHECK(map.erase(key));
+    for(int key = 0; key < 16; key++) {
+        const auto* value = map.find(key);
+        if(key % 3 == 0) {
+            CHECK(value == nullptr);
+        } else {
+            CHECK(value != nullptr);
+            if(value != nullptr) CHECK_EQUAL(key * 10, *value);
+        }
+    }
+    //and the freed room is reusable
+    for(int key = 100; key < 106; key++) CHECK(map.insert(key, key).has_value());
+    CHECK(map.full());
+}
+
+TEST(StaticHashMap,Churn)
+{
+    //many more insertions and erasures than slots: without tombstones
+    //the table never clogs up
+    utl::static_hash_map<uint32_t,uint32_t,32> map{};
+    utl::bench::lcg random{7};
+    utl::array<uint32_t,32> live{};
+    size_t n_live = 0;
+    for(size_t round = 0; round < 2000; round++) {
+        const uint32_t value = random();
+        if(n_live == live.size() or (n_live > 0 and (value >> 23) != 0)) {
+            const size_t victim = value % n_live;
+            CHECK(map.erase(live[victim]));
+            live[victim] = live[--n_live];
+        } else if(not map.contains(value >> 4)) {
+            CHECK(map.insert(value >> 4, static_cast<uint32_t>(round)).has_value());
+            live[n_live++] = value >> 4;
+        }
+        CHECK_EQUAL(n_live, map.size());
+    }
+    for(size_t idx = 0; idx < n_live; idx++) CHECK(map.contains(live[idx]));
+}
+
+TEST(StaticHashMap,RuntimeListDropsExtras)
+{
+    //built at runtime, entries past the capacity are dropped
+    int key = 3;
+    const utl::static_hash_map<int,int,2> map{{1, 1}, {2, 2}, {key, 3}};
+    CHECK_EQUAL(2u, map.size());
+    CHECK(not map.contains(key));
+}
+
+TEST_GROUP(StaticHashMapBenchmark) {};
+
+TEST(StaticHashMapBenchmark,Lookup)
+{
+    constexpr size_t iterations = 2000;
+    constexpr uint32_t n_keys = 64;
+    //sparse keys, as handles and config IDs are
+    static utl::array<pair_entry,n_keys> table{};
+    static utl::static_hash_map<uint32_t,uint32_t,n_keys> map{};
+    for(uint32_t idx = 0; idx < n_keys; idx++) {
+        table[idx] = {idx * 2654435761u >> 16, idx};
+        CHECK(map.insert(table[idx].key, idx).has_value());
+    }
+    static utl::array<uint32_t,1024> queries{};
+    utl::bench::lcg random{1};
+    for(auto& query : queries) query = table[random() >> 18].key;
+
+    uint32_t expected = 0;
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        uint32_t sum = 0;
+        for(auto query : queries) {
+            for(auto const& entry : table) {
+                if(entry.key == query) {
+                    sum += entry.value;
+                    break;
+                }
+            }
+        }
+        expected = sum;
+        utl::bench::keep(sum);
+    });
+    uint32_t found = 0;
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        uint32_t sum = 0;
+        for(auto query : queries) sum += *map.find(query);
+        found = sum;
+        utl::bench::keep(sum);
+    });
+    utl::bench::report("look up 1024 keys among 64"_sv, baseline, candidate);
+    CHECK_EQUAL(expected, found);
+}
@@ -0,0 +1,126 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/static-string.hh>
+#include <utl/format.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+constexpr auto make_greeting()
+{
+    utl::static_string<16> greeting{"hello"};
+    greeting += ',';
+    greeting += " world";
+    return greeting;
+}
+
+static_assert(make_greeting().length() == 12);
+static_assert(make_greeting() == "hello, world"_sv);
+static_assert(utl::static_string{"abc"}.capacity() == 3);
+
+} //anonymous namespace
+
+TEST_GROUP(StaticString) {};
+
+TEST(StaticString,Append)
+{
+    utl::static_string<10> str{};
+    CHECK(str.empty());
+    CHECK_EQUAL(3u, str.append("abc"));
+    CHECK(str.push_back('d'));
+    str += "ef"_sv;
+    CHECK_EQUAL(6u, str.length());
+    CHECK(str == "abcdef"_sv);
+    CHECK_EQUAL('\0', str.c_str()[6]);
+    CHECK(not str.truncated());
+
+    str.pop_back();
+    CHECK(str == "abcde"_sv);
+    str.clear();
+    CHECK(str.empty());
+    CHECK_EQUAL('\0', str.c_str()[0]);
+}
+
+TEST(StaticString,Truncation)
+{
+    utl::static_string<5> str{"abc"};
+    CHECK_EQUAL(2u, str.append("defg"));
+    CHECK(str == "abcde"_sv);
+    CHECK(str.full());
+    CHECK(str.truncated());
+    CHECK(not str.push_back('x'));
+    CHECK_EQUAL('\0', str.c_str()[5]);
+}
+
+TEST(StaticString,Find)
+{
+    utl::static_string<32> str{"rate=100;gain=4;"};
+    CHECK_EQUAL(9u, str.find("gain"_sv));
+    CHECK_EQUAL(13u, str.rfind("="_sv));
+    //only the contents are searched, not the rest of the buffer
+    CHECK_EQUAL(utl::npos, str.find(utl::string_view{"\0", 1}));
+}
+
+TEST(StaticString,Resize)
+{
+    utl::static_string<8> str{"abc"};
+    str.resize(6, '.');
+    CHECK(str == "abc..."_sv);
+    str.resize(2);
+    CHECK(str == "ab"_sv);
+    str.resize(20, '-');
+    CHECK_EQUAL(8u, str.length());
+    CHECK(str.truncated());
+}
+
+TEST(StaticString,Concatenate)
+{
+    const utl::static_string<4> lhs{"key="};
+    const utl::static_string<8> rhs{"value"};
+    const auto both = lhs + rhs;
+    CHECK_EQUAL(12u, both.capacity());
+    CHECK(both == "key=value"_sv);
+
+    size_t seen = 0;
+    for(char c : both) {
+        CHECK(c != '\0');
+        seen++;
+    }
+    CHECK_EQUAL(9u, seen);
+}
+
+TEST(StaticString,FormatInto)
+{
+    utl::static_string<32> message{"adc: "};
+    utl::format_into(message, "{} mV", 1234);
+    utl::format_into(message, ", {:#x}", 255u);
+    CHECK(message == "adc: 1234 mV, 0xff"_sv);
+
+    utl::static_string<8> small{};
+    utl::format_into(small, "{}{}", "abcdef"_sv, 123456);
+    CHECK(small == "abcdef12"_sv);
+    CHECK(small.truncated());
+
+    //static_strings can be formatted too
+    utl::static_string<32> outer{};
+    utl::format_into(outer, "[{}]", small);
+    CHECK(outer == "[abcdef12]"_sv);
+}
+
+TEST(StaticString,Format)
+{
+    const auto formatted = utl::format<16>("{}-{}", 12, "ab");
+    CHECK(formatted == "12-ab"_sv);
+    CHECK_EQUAL(5u, formatted.length());
+}
@@ -0,0 +1,178 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/span.hh>
+#include <utl/format.hh>
+#include <utl/static-string.hh>
+#include <utl/ranges.hh>
+#include <utl/ranges/adaptors.hh>
+#include <utl/static-vector.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+static_assert(utl::static_vector<int,4>::capacity() == 4);
+static_assert(utl::ranges::iterable<utl::static_vector<int,4>>);
+static_assert(utl::fmt::formattable<utl::static_vector<int,4>>);
+
+//counts constructions and destructions, to check the vector doesn't
+//leak or double-destroy elements
+struct tracked {
+    static inline int live = 0;
+    int value;
+
+    explicit tracked(int v) : value{v} { live++; }
+    tracked(tracked const& other) : value{other.value} { live++; }
+    tracked(tracked&& other) noexcept : value{other.value} { live++; }
+    tracked& operator=(tracked const&) = default;
+    tracked& operator=(tracked&&) = default;
+    ~tracked() { live--; }
+};
+
+int sum(utl::span<const int> values)
+{
+    int total = 0;
+    for(auto value : values) total += value;
+    return total;
+}
+
+} //anonymous namespace
+
+TEST_GROUP(StaticVector) {};
+
+TEST(StaticVector,PushAndPop)
+{
+    utl::static_vector<int,4> values{};
+    CHECK(values.empty());
+    values.push_back(1);
+    values.emplace_back(2);
+    CHECK(values.try_push_back(3).has_value());
+    CHECK(values.try_emplace_back(4).has_value());
+    CHECK(values.full());
+    CHECK_EQUAL(4u, values.size());
+    CHECK_EQUAL(1, values.front());
+    CHECK_EQUAL(4, values.back());
+
+    //full: the element isn't added
+    const auto res = values.try_push_back(5);
+    CHECK(not res.has_value());
+    CHECK_EQUAL(static_cast<int32_t>(utl::errc::out_of_bounds), res.error().value());
+    CHECK_EQUAL(4u, values.size());
+
+    values.pop_back();
+    CHECK_EQUAL(3, values.back());
+    values.clear();
+    CHECK(values.empty());
+}
+
+TEST(StaticVector,InsertAndErase)
+{
+    utl::static_vector<int,8> values{1, 2, 4, 5};
+    values.insert(values.begin() + 2, 3); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    values.insert(values.begin(), 0);
+    CHECK((values == utl::static_vector<int,6>{0, 1, 2, 3, 4, 5}));
+
+    values.erase(values.begin() + 1); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    CHECK((values == utl::static_vector<int,5>{0, 2, 3, 4, 5}));
+    values.erase(values.begin() + 1, values.begin() + 3); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    CHECK((values == utl::static_vector<int,3>{0, 4, 5}));
+
+    values.resize(5, 9);
+    CHECK((values == utl::static_vector<int,5>{0, 4, 5, 9, 9}));
+    values.resize(1);
+    CHECK_EQUAL(1u, values.size());
+}
+
+TEST(StaticVector,Lifetimes)
+{
+    {
+        utl::static_vector<tracked,8> values{};
+        values.emplace_back(1);
+        values.emplace_back(3);
+        values.emplace(values.begin() + 1, 2); //NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        CHECK_EQUAL(3, tracked::live);
+        CHECK_EQUAL(2, values[1].value);
+
+        auto copy = values;
+        CHECK_EQUAL(6, tracked::live);
+        copy.erase(copy.begin());
+        CHECK_EQUAL(5, tracked::live);
+        CHECK_EQUAL(2, copy[0].value);
+
+        auto moved = std::move(copy);
+        moved.pop_back();
+        values = moved;
+        CHECK_EQUAL(1u, values.size());
+        CHECK_EQUAL(2, values[0].value);
+    }
+    CHECK_EQUAL(0, tracked::live);
+}
+
+TEST(StaticVector,Interop)
+{
+    utl::static_vector<int,8> values{3, 1, 2};
+    //spans see just the elements in use
+    CHECK_EQUAL(6, sum(values));
+    const utl::span<int> view = values;
+    CHECK_EQUAL(3u, view.size());
+
+    int total = 0;
+    for(auto value : values | utl::ranges::transform([](int v) { return v * 10; })) total += value;
+    CHECK_EQUAL(60, total);
+
+    utl::static_string<32> text{};
+    utl::format_into(text, "{} {:02}", values, values);
+    CHECK(text == "[3, 1, 2] [03, 01, 02]"_sv);
+}
+
+TEST(StaticVector,FormatInto)
+{
+    //a vector of chars is an appendable format output; text past its
+    //capacity is dropped, not written past the end
+    struct {
+        utl::static_vector<char,4> text{};
+        utl::array<char,4> guard{'g', 'g', 'g', 'g'};
+    } guarded{};
+    utl::format_into(guarded.text, "{}{}", "abc"_sv, 1234);
+    CHECK_EQUAL(4u, guarded.text.size());
+    CHECK(utl::string_view(guarded.text.data(), guarded.text.size()) == "abc1"_sv);
+    for(char c : guarded.guard) CHECK_EQUAL('g', c);
+
+    utl::static_vector<uint8_t,2> bytes{};
+    utl::format_into(bytes, "{}", 123);
+    CHECK_EQUAL(2u, bytes.size());
+    CHECK_EQUAL('2', bytes[1]);
+}
+
+TEST(StaticVector,CopyTrivial)
+{
+    const utl::static_vector<int,16> values{4, 5, 6};
+    utl::static_vector<int,16> copy{values};
+    CHECK_EQUAL(3u, copy.size());
+    CHECK_EQUAL(15, sum(copy));
+    CHECK(copy.data() != values.data());
+
+    utl::static_vector<int,16> assigned{1, 2, 3, 4, 5, 6, 7};
+    assigned = values;
+    CHECK_EQUAL(3u, assigned.size());
+    CHECK_EQUAL(6, assigned.back());
+
+    const utl::static_vector<int,16> none{};
+    utl::static_vector<int,16> empty_copy{none};
+    CHECK(empty_copy.empty());
+    assigned = none;
+    CHECK(assigned.empty());
+    assigned.push_back(9);
+    CHECK_EQUAL(9, assigned.front());
+}
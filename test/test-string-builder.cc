@@ -0,0 +1,116 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utility>
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/format.hh>
+#include <utl/string-builder.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+constexpr size_t build_length()
+{
+    utl::array<char,32> buffer{};
+    utl::string_builder builder{buffer};
+    builder += "key";
+    builder += '=';
+    builder.append(3, '7');
+    return builder.length();
+}
+
+static_assert(build_length() == 7);
+
+} //anonymous namespace
+
+TEST_GROUP(StringBuilder) {};
+
+TEST(StringBuilder,Append)
+{
+    char buffer[16]; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    utl::string_builder builder{buffer};
+    CHECK(builder.empty());
+    CHECK_EQUAL(15u, builder.capacity());
+    CHECK_EQUAL(3u, builder.append("abc"));
+    CHECK(builder.push_back('d'));
+    builder += "ef"_sv;
+    CHECK(builder == "abcdef"_sv);
+    CHECK_EQUAL('\0', builder.c_str()[6]);
+    //the text is in the caller's buffer
+    CHECK_EQUAL(static_cast<const char*>(buffer), builder.data());
+
+    builder.truncate(2);
+    CHECK(builder == "ab"_sv);
+    builder.clear();
+    CHECK(builder.empty());
+    CHECK_EQUAL('\0', buffer[0]);
+}
+
+TEST(StringBuilder,Format)
+{
+    utl::array<char,64> buffer{};
+    utl::string_builder builder{buffer};
+    builder.format("uptime: {} s\n", 1234).format("{}: {} mV\n", "vbat"_sv, 3700);
+    utl::format_into(builder, "{:#x}", 255u);
+    CHECK(builder == "uptime: 1234 s\nvbat: 3700 mV\n0xff"_sv);
+    CHECK(not builder.truncated());
+
+    //builders can be formatted too
+    utl::array<char,64> outer_buffer{};
+    utl::string_builder outer{outer_buffer};
+    outer.format("[{}]", builder.view().substr(0, 6));
+    CHECK(outer == "[uptime]"_sv);
+}
+
+TEST(StringBuilder,Truncation)
+{
+    utl::array<char,9> buffer{};
+    utl::string_builder builder{buffer};
+    builder.format("{}{}", "abcdef"_sv, 123456);
+    CHECK(builder == "abcdef12"_sv);
+    CHECK(builder.full());
+    CHECK(builder.truncated());
+    CHECK(not builder.push_back('x'));
+    CHECK_EQUAL(0u, builder.append("more"));
+    CHECK_EQUAL('\0', buffer[8]);
+
+    builder.clear();
+    CHECK(not builder.truncated());
+
+    //a buffer with no room at all
+    utl::string_builder none{utl::span<char>{nullptr, 0}};
+    CHECK(not none.push_back('x'));
+    CHECK(none.truncated());
+    CHECK(none == ""_sv);
+}
+
+TEST(StringBuilder,Move)
+{
+    utl::array<char,16> buffer{};
+    utl::string_builder builder{buffer};
+    builder.append("abc");
+    utl::string_builder moved{std::move(builder)};
+    CHECK(moved == "abc"_sv);
+
+    //the moved-from builder no longer writes into the buffer
+    CHECK(builder.empty()); //NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+    CHECK(not builder.push_back('x'));
+    CHECK(moved == "abc"_sv);
+
+    utl::array<char,16> other_buffer{};
+    utl::string_builder other{other_buffer};
+    other = std::move(moved);
+    other.append("d");
+    CHECK(other == "abcd"_sv);
+    CHECK_EQUAL(0u, moved.capacity()); //NOLINT(bugprone-use-after-move,hicpp-invalid-access-moved)
+}
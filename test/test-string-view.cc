@@ -12,6 +12,26 @@
 #include "utl/test-types.hh"
 #include "utl/utl.hh"
 #include "utl/string-view.hh"
+#include "bench-support.hh"
+
+using namespace utl::literals;
+
+namespace {
+
+//long enough that a recursive search would exceed the constexpr depth
+//limit
+constexpr auto long_text = []{
+    struct { char text[2049]{}; } result{}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    for(size_t idx = 0; idx < 2048; idx++) result.text[idx] = static_cast<char>('a' + idx % 7); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    result.text[2040] = '!';
+    return result;
+}();
+
+static_assert(utl::string_view{long_text.text}.find("!") == 2040); //NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+static_assert(utl::string_view{long_text.text}.find("abc!") == 2037); //NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+static_assert(utl::string_view{long_text.text}.rfind("abc") == 2044); //NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+
+} //anonymous namespace
 
 TEST_GROUP(StringView) {};
 
@@ -76,3 +96,121 @@ TEST(StringView,ConstexprCompare)
 //     utl::maybe_unused(foo);
 // }
 
+TEST(StringView,Find)
+{
+    const utl::string_view text = "key=value; other key = other value; end"_sv;
+    CHECK_EQUAL(0u, text.find("key"_sv));
+    CHECK_EQUAL(17u, text.find("key"_sv, 1));
+    CHECK_EQUAL(3u, text.find('='));
+    CHECK_EQUAL(21u, text.find('=', 4));
+    CHECK_EQUAL(9u, text.find("; "_sv));
+    CHECK_EQUAL(36u, text.find("end"_sv));
+    CHECK_EQUAL(utl::npos, text.find("ends"_sv));
+    CHECK_EQUAL(utl::npos, text.find("key"_sv, 18));
+    CHECK_EQUAL(5u, text.find(""_sv, 5));
+    CHECK_EQUAL(utl::npos, text.find("x"_sv, 100));
+
+    //long enough for the skip table
+    const utl::string_view needle = "other key = other value; end"_sv;
+    CHECK_EQUAL(11u, text.find(needle));
+    const utl::string_view near_miss = "other key = other value; enD"_sv;
+    CHECK_EQUAL(utl::npos, text.find(near_miss));
+}
+
+TEST(StringView,FindEveryPosition)
+{
+    //every offset and needle length, against a plain loop
+    const utl::string_view text = "abababcabcdabcdeabcdefabcdefgabcdefghabcdefghiabcdefghijabcdefghijk"
+        "abcdefghijklabcdefghijklmabcdefghijklmnabcdefghijklmnoabcdefghijklmnop"_sv;
+    for(size_t start = 0; start < text.size(); start++) {
+        for(size_t len = 1; start + len <= text.size(); len++) {
+            const auto needle = text.substr(start, len);
+            size_t expected = utl::npos;
+            for(size_t pos = 0; pos + len <= text.size(); pos++) {
+                if(text.substr(pos, len).compare(needle)) {
+                    expected = pos;
+                    break;
+                }
+            }
+            CHECK_EQUAL(expected, text.find(needle));
+        }
+    }
+}
+
+TEST(StringView,Rfind)
+{
+    const utl::string_view text = "a.b.c.d"_sv;
+    CHECK_EQUAL(5u, text.rfind("."_sv));
+    CHECK_EQUAL(3u, text.rfind("."_sv, 4));
+    CHECK_EQUAL(1u, text.rfind("."_sv, 2));
+    CHECK_EQUAL(utl::npos, text.rfind("."_sv, 0));
+    CHECK_EQUAL(0u, text.rfind("a."_sv));
+    CHECK_EQUAL(utl::npos, text.rfind("e"_sv));
+    CHECK_EQUAL(7u, text.rfind(""_sv));
+
+    constexpr utl::string_view foo{"hello hello"};
+    static_assert(foo.rfind("hello") == 6);
+    static_assert(foo.rfind("hello", 5) == 0);
+    static_assert(foo.rfind("l", 5) == 3);
+}
+
+TEST_GROUP(StringViewBenchmark) {};
+
+TEST(StringViewBenchmark,Find)
+{
+    constexpr size_t iterations = 2000;
+
+    //a config file, searched for its last key
+    static char buffer[4096]{}; //NOLINT(cppcoreguidelines-avoid-c-arrays)
+    const utl::string_view line = "sensor.rate = 100; sensor.gain = 4; sensor.offset = -12;\n"_sv;
+    size_t used = 0;
+    while(used + line.size() < sizeof(buffer) - 64) {
+        __builtin_memcpy(&buffer[used], line.data(), line.size()); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        used += line.size();
+    }
+    const utl::string_view tail = "sensor.trim = 3;"_sv;
+    __builtin_memcpy(&buffer[used], tail.data(), tail.size()); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+    used += tail.size();
+    const utl::string_view text{buffer, used}; //NOLINT(cppcoreguidelines-pro-bounds-array-to-pointer-decay)
+
+    //the substr/starts_with loop find used to be
+    const auto naive = [](utl::string_view hay, utl::string_view needle) {
+        for(size_t idx = 0; idx + needle.size() <= hay.size(); idx++) {
+            if(hay.substr(idx, utl::npos).starts_with(needle)) return idx;
+        }
+        return utl::npos;
+    };
+
+    size_t expected = 0;
+    const auto baseline = utl::bench::measure(iterations, [&](size_t) {
+        expected = naive(text, "sensor.trim"_sv);
+        utl::bench::keep(expected);
+    });
+    size_t found = 0;
+    const auto candidate = utl::bench::measure(iterations, [&](size_t) {
+        found = text.find("sensor.trim"_sv);
+        utl::bench::keep(found);
+    });
+    utl::bench::report("find 11 chars in 4 KiB of config"_sv, baseline, candidate);
+    CHECK_EQUAL(expected, found);
+
+    const utl::string_view long_key = "sensor.trim = 3; and then some more text"_sv.substr(0, 16);
+    const auto naive_long = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(naive(text, long_key));
+    });
+    const auto long_found = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(text.find(long_key));
+    });
+    utl::bench::report("find 16 chars in 4 KiB of config"_sv, naive_long, long_found);
+    CHECK_EQUAL(used - tail.size(), text.find(long_key));
+
+    const utl::string_view longer = "sensor.offset = -12;\nsensor.rate = 100; sensor.gain = 4; sensor.trim = 3;"_sv;
+    const auto naive_longer = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(naive(text, longer));
+    });
+    const auto longer_found = utl::bench::measure(iterations, [&](size_t) {
+        utl::bench::keep(text.find(longer));
+    });
+    utl::bench::report("find 73 chars in 4 KiB of config"_sv, naive_longer, longer_found);
+    CHECK_EQUAL(naive(text, longer), text.find(longer));
+}
@@ -138,6 +138,17 @@ TEST(String,ConstexprFind)
     CHECK(c == utl::npos);
 }
 
+TEST(String,Rfind)
+{
+    constexpr utl::string foo{"hello hello"};
+    static_assert(foo.rfind("hello") == 6);
+    static_assert(foo.rfind("hello", 5) == 0);
+    CHECK_EQUAL(6u, foo.rfind("hello"));
+    CHECK_EQUAL(0u, foo.rfind("hello", 5));
+    CHECK_EQUAL(3u, foo.rfind("l", 5));
+    CHECK_EQUAL(utl::npos, foo.rfind("what?"));
+}
+
 TEST(String,Compare)
 {
     utl::string foo{"hello"};
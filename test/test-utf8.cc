@@ -0,0 +1,125 @@
+// Copyright 2022 George Harris
+//
+// All portions of UTL (github.com/goshdarnharris/utl) are licensed
+// under the Apache License, Version 2.0 (the "License").
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+
+/* vim: set tabstop=4 shiftwidth=4 expandtab filetype=cpp : */
+
+#include <CppUTest/TestHarness.h>
+#include "packages/libawful/include/awful.hpp"
+#include <utl/utl.hh>
+#include <utl/array.hh>
+#include <utl/utf8.hh>
+
+using namespace utl::literals;
+
+namespace {
+
+template <typename... Ts>
+constexpr auto bytes(Ts... values)
+{
+    return utl::array<uint8_t,sizeof...(Ts)>{static_cast<uint8_t>(values)...};
+}
+
+static_assert(utl::utf8::validate(bytes('a', 0xC3, 0xA9))); //"aé"
+static_assert(not utl::utf8::validate(bytes(0xC0, 0x80)));
+static_assert(utl::utf8::find_invalid(bytes('a', 'b', 0xFF)) == 2);
+
+constexpr size_t count_codepoints(utl::span<const uint8_t> text)
+{
+    size_t total = 0;
+    for([[maybe_unused]] auto codepoint : utl::utf8::codepoints(text)) total++;
+    return total;
+}
+
+static_assert(count_codepoints(bytes('a', 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80)) == 3);
+
+} //anonymous namespace
+
+TEST_GROUP(Utf8) {};
+
+TEST(Utf8,Valid)
+{
+    CHECK(utl::utf8::validate(""_sv));
+    CHECK(utl::utf8::validate("plain ASCII that is longer than sixteen bytes"_sv));
+    CHECK(utl::utf8::validate(bytes(0xC2, 0x80, 0xDF, 0xBF)));               //U+0080, U+07FF
+    CHECK(utl::utf8::validate(bytes(0xE0, 0xA0, 0x80, 0xEF, 0xBF, 0xBF)));   //U+0800, U+FFFF
+    CHECK(utl::utf8::validate(bytes(0xED, 0x9F, 0xBF, 0xEE, 0x80, 0x80)));   //either side of the surrogates
+    CHECK(utl::utf8::validate(bytes(0xF0, 0x90, 0x80, 0x80, 0xF4, 0x8F, 0xBF, 0xBF))); //U+10000, U+10FFFF
+}
+
+TEST(Utf8,Invalid)
+{
+    CHECK(not utl::utf8::validate(bytes(0x80)));                    //stray continuation
+    CHECK(not utl::utf8::validate(bytes(0xC1, 0xBF)));              //overlong two-byte
+    CHECK(not utl::utf8::validate(bytes(0xE0, 0x9F, 0xBF)));        //overlong three-byte
+    CHECK(not utl::utf8::validate(bytes(0xED, 0xA0, 0x80)));        //surrogate
+    CHECK(not utl::utf8::validate(bytes(0xF0, 0x8F, 0xBF, 0xBF)));  //overlong four-byte
+    CHECK(not utl::utf8::validate(bytes(0xF4, 0x90, 0x80, 0x80)));  //past U+10FFFF
+    CHECK(not utl::utf8::validate(bytes(0xF5, 0x80, 0x80, 0x80)));
+    CHECK(not utl::utf8::validate(bytes(0xE2, 0x82)));              //truncated
+
+    //found after a long ASCII run, at any alignment
+    for(size_t offset = 0; offset < 40; offset++) {
+        utl::array<uint8_t,48> text{};
+        for(auto& byte : text) byte = 'x';
+        text[offset] = 0xE2;
+        text[offset + 1] = 0x28;
+        CHECK_EQUAL(offset, utl::utf8::find_invalid(text));
+    }
+}
+
+TEST(Utf8,Codepoints)
+{
+    const auto text = bytes('a', 0xC3, 0xA9, 0xE2, 0x82, 0xAC, 0xF0, 0x9F, 0x98, 0x80);
+    const char32_t expected[] = {U'a', U'é', U'€', U'\U0001F600'};
+    size_t idx = 0;
+    for(auto codepoint : utl::utf8::codepoints(text)) {
+        CHECK(idx < 4);
+        if(idx < 4) CHECK_EQUAL(static_cast<uint32_t>(expected[idx]), static_cast<uint32_t>(codepoint)); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        idx++;
+    }
+    CHECK_EQUAL(4u, idx);
+
+    //each bad sequence becomes a single U+FFFD
+    const auto bad = bytes('a', 0xE2, 0x82, 'b', 0xFF, 'c');
+    const char32_t replaced[] = {U'a', 0xFFFD, U'b', 0xFFFD, U'c'};
+    idx = 0;
+    for(auto codepoint : utl::utf8::codepoints(bad)) {
+        if(idx < 5) CHECK_EQUAL(static_cast<uint32_t>(replaced[idx]), static_cast<uint32_t>(codepoint)); //NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        idx++;
+    }
+    CHECK_EQUAL(5u, idx);
+}
+
+TEST(Utf8,ToUtf16)
+{
+    const auto text = bytes('U', 'S', 'B', 0xC3, 0xA9, 0xF0, 0x9F, 0x98, 0x80);
+    CHECK_EQUAL(12u, utl::utf8::utf16_size(text));
+    utl::array<uint8_t,12> out{};
+    const auto res = utl::utf8::to_utf16le(text, out);
+    CHECK(res.has_value());
+    CHECK_EQUAL(12u, res.value());
+    const auto expected = bytes('U', 0, 'S', 0, 'B', 0, 0xE9, 0x00, 0x3D, 0xD8, 0x00, 0xDE);
+    for(size_t idx = 0; idx < expected.size(); idx++) CHECK_EQUAL(expected[idx], out[idx]);
+
+    utl::array<uint8_t,10> short_out{};
+    CHECK(not utl::utf8::to_utf16le(text, short_out).has_value());
+
+    //long enough to take the block path
+    const auto ascii = "A USB product string, all of it ASCII"_sv;
+    utl::array<uint8_t,80> wide{};
+    const auto wide_res = utl::utf8::to_utf16le(ascii, wide);
+    CHECK(wide_res.has_value());
+    CHECK_EQUAL(2 * ascii.size(), wide_res.value());
+    for(size_t idx = 0; idx < ascii.size(); idx++) {
+        CHECK_EQUAL(static_cast<uint8_t>(ascii[idx]), wide[2 * idx]);
+        CHECK_EQUAL(0u, wide[2 * idx + 1]);
+    }
+    utl::array<uint8_t,10> narrow{};
+    CHECK(not utl::utf8::to_utf16le(ascii, narrow).has_value());
+    CHECK_EQUAL('A', narrow[0]);
+    CHECK_EQUAL('B', narrow[8]);
+}
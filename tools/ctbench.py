@@ -0,0 +1,423 @@
+#!/usr/bin/env python3
+# vim: set tabstop=4 shiftwidth=4 expandtab filetype=python
+
+# Compile-time benchmarks for the template-heavy headers.
+#
+# Generates stress translation units that scale one dimension of a header
+# (registers per apply(), fields per bitstruct, tuple elements, fold depth,
+# mixins per mix), compiles them with -ftime-trace and reports frontend time
+# and template instantiation counts for each one.
+#
+#   tools/ctbench.py generate build/ctbench             # just write the TUs
+#   tools/ctbench.py report build/x86_64/ctbench        # summarize existing traces
+#   tools/ctbench.py run --out build/ctbench            # generate, compile, report
+#   tools/ctbench.py run --json now.json --baseline before.json
+#
+# MODE=ctbench in the Roastfile builds the generated TUs with -ftime-trace as
+# part of the normal build; `report` then reads the traces it leaves next to
+# the object files. `run` drives the compiler directly for when that's more
+# convenient. Instantiation counts are deterministic, so they're what the
+# baseline comparison fails on; times are reported but only compared when
+# --time-threshold is given.
+
+import argparse, json, os, re, shutil, subprocess, sys, time
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+DEFAULT_SIZES = [8, 32, 64]
+
+#Instantiations are attributed to a header by the qualified name of the
+#template; clang 14's time trace doesn't record where a template lives.
+HEADERS = [
+    ("utl::registers::ops::", "register/op.hh"),
+    ("utl::registers::", "register/register.hh"),
+    ("utl::pal::", "pal.hh"),
+    ("utl::bitstruct", "bitfield.hh"),
+    ("utl::bitfield", "bitfield.hh"),
+    ("utl::get_field", "bitfield.hh"),
+    ("utl::hof::", "hof/fold.hh"),
+    ("utl::mix::", "mixin.hh"),
+    ("utl::tuple", "tuple.hh"),
+    ("utl::detail::tuple", "tuple.hh"),
+    ("utl::get<", "tuple.hh"),
+    ("utl::apply", "tuple.hh"),
+    ("utl::get_type", "type-list.hh"),
+    ("utl::detail::get_type", "type-list.hh"),
+    ("utl::find_type_index", "type-list.hh"),
+]
+
+INSTANTIATIONS = ("InstantiateClass", "InstantiateFunction")
+
+PREAMBLE = """\
+// Generated by tools/ctbench.py; do not edit.
+// {description}
+
+#include <stddef.h>
+#include <stdint.h>
+#include <utility>
+"""
+
+
+def op_compose(n):
+    #n fields spread over n/4 registers, so apply() has to both group
+    #and merge.
+    n_registers = (n + 3) // 4
+    lines = [PREAMBLE.format(description="apply() over {0} field ops on {1} registers".format(n, n_registers))]
+    lines.append("#include <utl/register/register.hh>")
+    lines.append("#include <utl/register/field.hh>")
+    lines.append("#include <utl/register/op.hh>")
+    lines.append("#include <utl/register/host.hh>")
+    lines.append("")
+    lines.append("namespace {")
+    lines.append("")
+    for r in range(n_registers):
+        lines.append("struct r{0} : utl::registers::host::mock_register<0x{1:08X}> {{}};".format(r, 0x4000_0000 + 4 * r))
+    for f in range(n):
+        lines.append("using f{0} = utl::registers::field::field<r{1},{2},8>;".format(f, f // 4, (f % 4) * 8))
+    lines.append("")
+    lines.append("[[maybe_unused]] void stress()")
+    lines.append("{")
+    ops = ["utl::registers::ops::assign(f{0}{{}}, {1}u)".format(f, f % 256) for f in range(n)]
+    lines.append("    utl::registers::ops::apply(")
+    lines.append("        " + ",\n        ".join(ops))
+    lines.append("    );")
+    lines.append("}")
+    lines.append("")
+    lines.append("} //anonymous namespace")
+    return "\n".join(lines) + "\n"
+
+
+def bitfield_wide(n):
+    #1-bit fields keep the backing integer within what _BitInt supports.
+    lines = [PREAMBLE.format(description="bitstruct with {0} fields, each looked up by tag".format(n))]
+    lines.append("#include <utl/bitfield.hh>")
+    lines.append("")
+    lines.append("namespace {")
+    lines.append("")
+    lines.append("enum class tag : uint8_t {};")
+    lines.append("")
+    lines.append("template <size_t... Is>")
+    lines.append("auto make(std::index_sequence<Is...>)")
+    lines.append("    -> utl::bitstruct<utl::bitfield<static_cast<tag>(Is), utl::uintn_t<1>>...>;")
+    lines.append("")
+    lines.append("using wide_t = decltype(make(std::make_index_sequence<{0}>{{}}));".format(n))
+    lines.append("")
+    lines.append("[[maybe_unused]] void stress(wide_t& value)")
+    lines.append("{")
+    for f in range(n):
+        lines.append("    utl::get_field<static_cast<tag>({0})>(value) = 1;".format(f))
+    lines.append("}")
+    lines.append("")
+    lines.append("} //anonymous namespace")
+    return "\n".join(lines) + "\n"
+
+
+def pal_peripheral(n):
+    lines = [PREAMBLE.format(description="peripheral with {0} registers, each field looked up through pal".format(n))]
+    lines.append("#include <utl/bitfield.hh>")
+    lines.append("#include <utl/pal.hh>")
+    lines.append("#include <utl/tuple.hh>")
+    lines.append("")
+    lines.append("namespace {")
+    lines.append("")
+    for r in range(n):
+        lines.append("enum class reg{0} : uint8_t {{ a, b }};".format(r))
+        lines.append("using reg{0}_t = utl::bitstruct<utl::bitfield<reg{0}::a, utl::uintn_t<8>>, utl::bitfield<reg{0}::b, utl::uintn_t<8>>>;".format(r))
+    lines.append("")
+    lines.append("struct peripheral {")
+    for r in range(n):
+        lines.append("    reg{0}_t r{0}{{}};".format(r))
+    refs = ", ".join("reg{0}_t&".format(r) for r in range(n))
+    members = ", ".join("r{0}".format(r) for r in range(n))
+    lines.append("")
+    lines.append("    constexpr auto registers() {{ return utl::tuple<{0}>{{{1}}}; }}".format(refs, members))
+    lines.append("};")
+    lines.append("")
+    lines.append("[[maybe_unused]] void stress(peripheral& p)")
+    lines.append("{")
+    for r in range(n):
+        lines.append("    utl::pal::get_field<reg{0}::b>(p) = {1};".format(r, r % 256))
+    lines.append("}")
+    lines.append("")
+    lines.append("} //anonymous namespace")
+    return "\n".join(lines) + "\n"
+
+
+def tuple_elements(n):
+    types = ", ".join(("uint8_t", "uint16_t", "uint32_t", "uint64_t")[e % 4] for e in range(n))
+    lines = [PREAMBLE.format(description="{0}-element tuple: construction, get<> and apply".format(n))]
+    lines.append("#include <utl/tuple.hh>")
+    lines.append("")
+    lines.append("namespace {")
+    lines.append("")
+    lines.append("using wide_t = utl::tuple<{0}>;".format(types))
+    lines.append("")
+    lines.append("[[maybe_unused]] uint64_t stress(wide_t& value)")
+    lines.append("{")
+    lines.append("    uint64_t sum = 0;")
+    for e in range(n):
+        lines.append("    sum += utl::get<{0}>(value);".format(e))
+    lines.append("    sum += utl::apply([](auto... items) { return (uint64_t{0} + ... + items); }, value);")
+    lines.append("    return sum;")
+    lines.append("}")
+    lines.append("")
+    lines.append("} //anonymous namespace")
+    return "\n".join(lines) + "\n"
+
+
+def fold_depth(n):
+    #Distinct element types, so every step of the fold is a separate
+    #instantiation of the fold operator.
+    lines = [PREAMBLE.format(description="hof::foldl over {0} distinct element types".format(n))]
+    lines.append("#include <utl/tuple.hh>")
+    lines.append("#include <utl/hof/fold.hh>")
+    lines.append("")
+    lines.append("namespace {")
+    lines.append("")
+    lines.append("template <size_t I>")
+    lines.append("struct element { uint32_t value; };")
+    lines.append("")
+    lines.append("[[maybe_unused]] uint32_t stress()")
+    lines.append("{")
+    elements = ", ".join("element<{0}>{{{0}}}".format(e) for e in range(n))
+    lines.append("    const auto items = utl::make_tuple({0});".format(elements))
+    lines.append("    return utl::hof::foldl(items, uint32_t{0}, [](uint32_t accum, auto const& item) {")
+    lines.append("        return accum + item.value;")
+    lines.append("    });")
+    lines.append("}")
+    lines.append("")
+    lines.append("} //anonymous namespace")
+    return "\n".join(lines) + "\n"
+
+
+def mixin_width(n):
+    #Note: utl/mixin.hh doesn't currently build with clang 14 (see
+    #test-mixin.cc); these are reported as failures until it does.
+    lines = [PREAMBLE.format(description="mix of {0} mixins".format(n))]
+    lines.append("#include <utl/mixin.hh>")
+    lines.append("")
+    lines.append("namespace {")
+    lines.append("")
+    for m in range(n):
+        lines.append("template <typename S> struct m{0} {{ uint32_t v{0} = {0}; }};".format(m))
+    lines.append("")
+    lines.append("using wide_t = utl::mix::mix<{0}>;".format(", ".join("m{0}".format(m) for m in range(n))))
+    lines.append("")
+    lines.append("[[maybe_unused]] uint32_t stress(wide_t& value)")
+    lines.append("{")
+    lines.append("    uint32_t sum = 0;")
+    for m in range(n):
+        lines.append("    sum += value.v{0};".format(m))
+    lines.append("    return sum;")
+    lines.append("}")
+    lines.append("")
+    lines.append("} //anonymous namespace")
+    return "\n".join(lines) + "\n"
+
+
+FAMILIES = {
+    "op_compose": (op_compose, "register/op.hh"),
+    "bitfield_wide": (bitfield_wide, "bitfield.hh"),
+    "pal_peripheral": (pal_peripheral, "pal.hh"),
+    "tuple_elements": (tuple_elements, "tuple.hh"),
+    "fold_depth": (fold_depth, "hof/fold.hh"),
+    "mixin_width": (mixin_width, "mixin.hh"),
+}
+
+
+def generate(out, sizes, families):
+    os.makedirs(out, exist_ok=True)
+    sources = []
+    for family in families:
+        make, _ = FAMILIES[family]
+        for n in sizes:
+            path = os.path.join(out, "{0}_{1}.cc".format(family, n))
+            text = make(n)
+            #leave unchanged TUs alone so the build doesn't redo them
+            if not os.path.isfile(path) or open(path).read() != text:
+                with open(path, "w") as f:
+                    f.write(text)
+            sources.append(path)
+    return sources
+
+
+def header_of(name):
+    for prefix, header in HEADERS:
+        if name.startswith(prefix):
+            return header
+    return None
+
+
+def summarize_trace(path):
+    with open(path) as f:
+        trace = json.load(f)
+    events = trace["traceEvents"] if isinstance(trace, dict) else trace
+
+    summary = {"frontend_ms": 0.0, "instantiations": {}, "headers": {}}
+    for kind in INSTANTIATIONS:
+        summary["instantiations"][kind] = 0
+    sources = {}
+
+    for event in events:
+        name = event.get("name", "")
+        detail = event.get("args", {}).get("detail", "")
+        duration_ms = event.get("dur", 0) / 1000.0
+        if name == "Total Frontend":
+            summary["frontend_ms"] = duration_ms
+        elif name in INSTANTIATIONS:
+            summary["instantiations"][name] += 1
+            header = header_of(detail)
+            if header is not None:
+                entry = summary["headers"].setdefault(header, {"parse_ms": 0.0, "instantiations": 0, "instantiate_ms": 0.0})
+                entry["instantiations"] += 1
+                #inclusive of whatever else the instantiation pulled in
+                entry["instantiate_ms"] += duration_ms
+        elif name == "Source" and "/include/utl/" in detail:
+            #a header's first inclusion is the one that costs anything
+            header = detail.split("/include/utl/", 1)[1]
+            sources.setdefault(header, duration_ms)
+
+    for header, parse_ms in sources.items():
+        entry = summary["headers"].setdefault(header, {"parse_ms": 0.0, "instantiations": 0, "instantiate_ms": 0.0})
+        entry["parse_ms"] = parse_ms
+    return summary
+
+
+def find_traces(directory):
+    traces = {}
+    for base, _, files in os.walk(directory):
+        for name in files:
+            #clang writes foo.json next to foo.o (or foo.cc.json for foo.cc.o)
+            match = re.match(r"^((?:" + "|".join(FAMILIES) + r")_\d+)(?:\.cc)?\.json$", name)
+            if match:
+                traces[match.group(1)] = os.path.join(base, name)
+    return traces
+
+
+def sort_key(name):
+    family, n = name.rsplit("_", 1)
+    return (family, int(n))
+
+
+def report(results, failures, out):
+    out.write("{0:<22} {1:>12} {2:>10} {3:>10}\n".format("tu", "frontend ms", "classes", "functions"))
+    for name in sorted(results, key=sort_key):
+        r = results[name]
+        out.write("{0:<22} {1:>12.1f} {2:>10} {3:>10}\n".format(name, r["frontend_ms"],
+            r["instantiations"]["InstantiateClass"], r["instantiations"]["InstantiateFunction"]))
+        for header, h in sorted(r["headers"].items(), key=lambda item: -(item[1]["parse_ms"] + item[1]["instantiate_ms"])):
+            if h["instantiations"] == 0 and h["parse_ms"] < 1.0:
+                continue
+            out.write("    {0:<28} parse {1:>8.1f} ms  instantiate {2:>8.1f} ms  {3:>6} instantiations\n".format(
+                header, h["parse_ms"], h["instantiate_ms"], h["instantiations"]))
+    for name in sorted(failures, key=sort_key):
+        out.write("{0:<22} failed to compile\n".format(name))
+
+
+def compare(results, baseline, count_threshold, time_threshold, out):
+    regressions = 0
+    for name in sorted(results, key=sort_key):
+        if name not in baseline:
+            continue
+        now = results[name]
+        before = baseline[name]
+        checks = [(kind, before["instantiations"].get(kind, 0), now["instantiations"][kind], count_threshold)
+            for kind in INSTANTIATIONS]
+        if time_threshold is not None:
+            checks.append(("frontend ms", before["frontend_ms"], now["frontend_ms"], time_threshold))
+        for what, old, new, threshold in checks:
+            if old > 0 and (new - old) * 100.0 / old > threshold:
+                out.write("regression: {0} {1} {2} -> {3}\n".format(name, what, old, new))
+                regressions += 1
+    return regressions
+
+
+def compile_flags(args):
+    #the Roastfile's language flags, without -Werror/-Weverything: the
+    #generated code is compiled for timing, not linted
+    flags = ["-std=c++20", "-DUTL_BUILD_NOCXX=1", "-fno-rtti", "-fno-exceptions",
+        "-fno-threadsafe-statics", "-fcoroutines-ts", "-O" + args.optimize,
+        "-isystem", os.path.join(ROOT, "packages/duck_invoke/include"),
+        "-I", os.path.join(ROOT, "include"), "-I", os.path.join(ROOT, "test-platform"), "-I", ROOT]
+    return flags + ["-ftime-trace", "-ftime-trace-granularity=0"]
+
+
+def run(args):
+    families = args.family or list(FAMILIES)
+    sources = generate(args.out, args.sizes, families)
+    cxx = os.environ.get("CXX", "clang++")
+    if shutil.which(cxx) is None:
+        sys.exit("ctbench: {0} not found; set CXX to a clang with -ftime-trace".format(cxx))
+
+    failures = []
+    for source in sources:
+        name = os.path.splitext(os.path.basename(source))[0]
+        obj = os.path.splitext(source)[0] + ".o"
+        start = time.monotonic()
+        status = subprocess.run([cxx] + compile_flags(args) + ["-c", source, "-o", obj],
+            stdout=subprocess.DEVNULL, stderr=subprocess.PIPE, text=True)
+        if status.returncode != 0:
+            failures.append(name)
+            if args.verbose:
+                sys.stderr.write(status.stderr)
+        elif args.verbose:
+            sys.stderr.write("{0}: {1:.2f} s\n".format(name, time.monotonic() - start))
+    return finish(args, find_traces(args.out), failures)
+
+
+def finish(args, traces, failures):
+    results = {name: summarize_trace(path) for name, path in traces.items()}
+    report(results, failures, sys.stdout)
+    if args.json:
+        with open(args.json, "w") as f:
+            json.dump(results, f, indent=2, sort_keys=True)
+    regressions = 0
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+        regressions = compare(results, baseline, args.count_threshold, args.time_threshold, sys.stdout)
+    return 1 if regressions > 0 else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description="compile-time benchmarks for the utl headers")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    def sizes(text):
+        return [int(n) for n in text.split(",")]
+
+    def add_report_options(p):
+        p.add_argument("--json", help="write the per-TU summary here")
+        p.add_argument("--baseline", help="a summary written by --json to compare against")
+        p.add_argument("--count-threshold", type=float, default=5.0,
+            help="percent increase in instantiations counted as a regression")
+        p.add_argument("--time-threshold", type=float, default=None,
+            help="percent increase in frontend time counted as a regression (off by default)")
+
+    p = commands.add_parser("generate", help="write the stress TUs")
+    p.add_argument("out")
+    p.add_argument("--sizes", type=sizes, default=DEFAULT_SIZES)
+    p.add_argument("--family", action="append", choices=sorted(FAMILIES))
+
+    p = commands.add_parser("report", help="summarize the time traces under a directory")
+    p.add_argument("directory")
+    add_report_options(p)
+
+    p = commands.add_parser("run", help="generate, compile with $CXX and report")
+    p.add_argument("--out", default=os.path.join(ROOT, "build/ctbench"))
+    p.add_argument("--sizes", type=sizes, default=DEFAULT_SIZES)
+    p.add_argument("--family", action="append", choices=sorted(FAMILIES))
+    p.add_argument("--optimize", default="0")
+    p.add_argument("--verbose", action="store_true")
+    add_report_options(p)
+
+    args = parser.parse_args()
+    if args.command == "generate":
+        generate(args.out, args.sizes, args.family or list(FAMILIES))
+        return 0
+    if args.command == "report":
+        return finish(args, find_traces(args.directory), [])
+    return run(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())